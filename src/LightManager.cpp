@@ -1,15 +1,22 @@
 #include "LightManager.h"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
-#include <thread>
 
 #include "SKSE/SKSE.h"
+#include "ShadowPolicy.h"
 #include "actor/ActorTracker.h"
 #include "core/Config.h"
+#include "core/ConfigRegistry.h"
+#include "core/EffectIndex.h"
 #include "core/Globals.h"
 #include "utils/Console.h"
+#include "utils/Hash.h"
 #include "utils/Light.h"
-#include "utils/MagicEffect.h"
+#include "utils/LightClusters.h"
+#include "utils/ShadowDistanceKernel.h"
+#include "utils/TaskScheduler.h"
 #include "utils/Transforms.h"
 
 namespace ActorShadowLimiter {
@@ -36,56 +43,54 @@ namespace ActorShadowLimiter {
         return nullptr;
     }
 
-    void ForceCastSpell(RE::Actor* actor, RE::SpellItem* spell, bool withShadows, bool skipIfNotActive) {
+    bool ForceCastSpell(RE::Actor* actor, RE::SpellItem* spell, bool withShadows, bool skipIfNotActive) {
         if (!actor || !spell) {
-            return;
+            return false;
         }
 
         // Skip execution and remove tracked actor if the spell's
         // magic effect is not active on the actor.
-        auto activeSpells = GetActiveConfiguredSpells(actor);
-        bool isSpellActive =
-            std::find(activeSpells.begin(), activeSpells.end(), spell->GetFormID()) != activeSpells.end();
-        if (skipIfNotActive && !isSpellActive) {
+        if (skipIfNotActive && !IsConfiguredSpellActive(actor, spell->GetFormID())) {
             DebugPrint("WARN", actor, "Skipping spell light 0x%08X - magic effect not active on actor",
                        spell->GetFormID());
-            ActorTracker::GetSingleton().RemoveActor(actor->GetFormID());
-            return;
+            ActorTracker::GetSingleton().RemoveActorLight(actor->GetFormID(), spell->GetFormID());
+            return false;
         }
         auto actorFormId = actor->GetFormID();
-        auto* light = spell->effects[0]->baseEffect->data.associatedForm->As<RE::TESObjectLIGH>();
+        auto* light = GetConfigRegistry().Find(spell->GetFormID()).light;
         if (!light) {
             DebugPrint("ERROR", "Associated form for spell 0x%08X is not a light. Cannot cast.", spell->GetFormID());
-            return;
+            return false;
         }
-        SetLightTypeNative(light, withShadows);
 
         auto* caster = actor->GetMagicCaster(RE::MagicSystem::CastingSource::kInstant);
         if (!caster) {
-            return;
+            return false;
         }
 
         auto* trackedActor = ActorTracker::GetSingleton().GetOrCreateActor(actorFormId);
-        trackedActor->SetLightShadowState(spell->GetFormID(), withShadows);
+        if (!trackedActor || !trackedActor->SetLightShadowState(spell->GetFormID(), withShadows)) {
+            return false;
+        }
+
+        // Only switch the base form once the cast is certain, the restore below undoes it
+        SetLightTypeNative(light, withShadows);
         caster->CastSpellImmediate(spell, false, actor, 1.0f, false, 0.0f, nullptr);
 
         // Restore base form after a delay so the reference keeps shadows but base form doesn't
-        std::thread([light, actorFormId, spellFormId = spell->GetFormID()]() {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(1000ms);  // Longer delay to ensure reference is fully created with shadows
-
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([light, actorFormId, spellFormId]() {
-                    // Restore the base form
-                    SetLightTypeNative(light, false);
-
-                    // Re-fetch actor pointer to ensure it's valid
-                    if (auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId)) {
-                        AdjustSpellLightPosition(actor, spellFormId);
-                    }
-                });
+        // Longer delay to ensure reference is fully created with shadows
+        using namespace std::chrono_literals;
+        TaskScheduler::GetSingleton().Schedule(1000ms, [light, actorFormId, spellFormId = spell->GetFormID()]() {
+            // Restore the base form
+            SetLightTypeNative(light, false);
+            InvalidateSceneSnapshot();
+
+            // Re-fetch actor pointer to ensure it's valid
+            if (auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId)) {
+                AdjustSpellLightPosition(actor, spellFormId);
             }
-        }).detach();
+        });
+        return true;
     }
 
     /**
@@ -94,18 +99,22 @@ namespace ActorShadowLimiter {
      * 1. Modifying the tracked actors re-equip state and light shadow state
      * 2. Modifying the base form to the correct shadow/no-shadow type
      */
-    void ForceReEquipLight(RE::Actor* actor, RE::TESObjectLIGH* light, bool withShadows) {
+    bool ForceReEquipLight(RE::Actor* actor, RE::TESObjectLIGH* light, bool withShadows) {
         auto* equipManager = RE::ActorEquipManager::GetSingleton();
-        TrackedActor* trackedActor = ActorTracker::GetSingleton().GetActor(actor->GetFormID());
+        auto& actorTracker = ActorTracker::GetSingleton();
+        ActorHandle trackedHandle = actorTracker.FindHandle(actor->GetFormID());
+        TrackedActor* trackedActor = actorTracker.Resolve(trackedHandle);
         if (!equipManager || !trackedActor) {
             DebugPrint("Warn",
                        "Failed to get equip manager or tracked actor for actor 0x%08X. Cannot re-equip light 0x%08X.",
                        actor->GetFormID(), light->GetFormID());
-            return;
+            return false;
         }
 
-        trackedActor->SetReEquipping(true);
-        trackedActor->SetLightShadowState(light->GetFormID(), withShadows);
+        if (!trackedActor->SetLightShadowState(light->GetFormID(), withShadows)) {
+            return false;
+        }
+        trackedActor->SetReEquipping(light->GetFormID(), true);
 
         SetLightTypeNative(light, withShadows);
 
@@ -114,106 +123,127 @@ namespace ActorShadowLimiter {
         uint32_t lightFormId = light->GetFormID();
         uint32_t actorFormId = actor->GetFormID();
 
-        // Do entire sequence in one thread with delays between operations
-        std::thread([actor, light, lightFormId, actorFormId, slot, equipManager, trackedActor]() {
-            using namespace std::chrono_literals;
-            constexpr auto initialDelay = 100ms;
-            constexpr auto unequipWaitTime = 100ms;
-            constexpr auto restoreFormDelay = 1000ms;
-
-            // Initial delay before starting operations
-            std::this_thread::sleep_for(initialDelay);
+        // Each step runs on the main thread its delay after the previous one
+        using namespace std::chrono_literals;
+        constexpr auto initialDelay = 100ms;
+        constexpr auto unequipWaitTime = 100ms;
+        constexpr auto restoreFormDelay = 1000ms;
 
+        TaskScheduler::GetSingleton().ScheduleSequence({
             // Unequip
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([actor, light, slot, equipManager]() {
-                    equipManager->UnequipObject(actor, light, nullptr, 1, slot, true, false, false, false, nullptr);
-                });
-            }
-
-            // Wait for unequip to complete
-            std::this_thread::sleep_for(unequipWaitTime);
-
-            // Re-equip
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([actor, light, slot, equipManager]() {
-                    equipManager->EquipObject(actor, light, nullptr, 1, slot, true, false, false, false);
-                });
-            }
-
-            // Wait for reference to be created with shadows
-            std::this_thread::sleep_for(restoreFormDelay);
-
-            // Restore base form
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([light, lightFormId, actorFormId]() {
-                    // Restore the base form
-                    SetLightTypeNative(light, false);
-
-                    // Re-fetch actor pointer to ensure it's valid
-                    if (auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId)) {
-                        AdjustHeldLightPosition(actor, lightFormId);
-                    }
-
-                    // Re-fetch to ensure valid pointer
-                    if (auto* trackedActor = ActorTracker::GetSingleton().GetActor(actorFormId)) {
-                        trackedActor->SetReEquipping(false);
-                    }
-                });
-            }
-        }).detach();
+            {initialDelay,
+             [actor, light, slot, equipManager]() {
+                 equipManager->UnequipObject(actor, light, nullptr, 1, slot, true, false, false, false, nullptr);
+             }},
+            // Re-equip once the unequip completed
+            {unequipWaitTime,
+             [actor, light, slot, equipManager]() {
+                 equipManager->EquipObject(actor, light, nullptr, 1, slot, true, false, false, false);
+             }},
+            // Restore the base form once the reference was created with shadows
+            {restoreFormDelay,
+             [light, lightFormId, actorFormId, trackedHandle]() {
+                 SetLightTypeNative(light, false);
+
+                 // Re-fetch actor pointer to ensure it's valid
+                 if (auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId)) {
+                     AdjustHeldLightPosition(actor, lightFormId);
+                 }
+
+                 // Stale if the actor was untracked meanwhile, a re-tracked actor starts a fresh state
+                 if (auto* trackedActor = ActorTracker::GetSingleton().Resolve(trackedHandle)) {
+                     trackedActor->SetReEquipping(lightFormId, false);
+                 }
+                 InvalidateSceneSnapshot();
+             }},
+        });
+        return true;
     }
 
-    void ForceReEquipArmor(RE::Actor* actor, RE::TESObjectARMO* armor, bool withShadows) {
+    bool ForceReEquipArmor(RE::Actor* actor, RE::TESObjectARMO* armor, bool withShadows) {
         auto* equipManager = RE::ActorEquipManager::GetSingleton();
         if (!equipManager) {
-            return;
+            return false;
         }
 
-        TrackedActor* trackedActor = ActorTracker::GetSingleton().GetActor(actor->GetFormID());
-        trackedActor->SetReEquipping(true);
-        trackedActor->SetLightShadowState(armor->GetFormID(), withShadows);
+        auto& actorTracker = ActorTracker::GetSingleton();
+        ActorHandle trackedHandle = actorTracker.FindHandle(actor->GetFormID());
+        TrackedActor* trackedActor = actorTracker.Resolve(trackedHandle);
+        if (!trackedActor) {
+            DebugPrint("WARN", actor, "Actor is not tracked. Cannot re-equip armor 0x%08X.", armor->GetFormID());
+            return false;
+        }
+        if (!trackedActor->SetLightShadowState(armor->GetFormID(), withShadows)) {
+            return false;
+        }
+        trackedActor->SetReEquipping(armor->GetFormID(), true);
 
-        auto* armorLight = GetLightFromEnchantedArmor(armor);
+        auto* armorLight = GetConfigRegistry().Find(armor->GetFormID()).light;
+        if (!armorLight) {
+            DebugPrint("WARN", actor, "No light found in armor 0x%08X enchantment", armor->GetFormID());
+        }
         SetLightTypeNative(armorLight, withShadows);
 
-        // Do entire sequence in one thread with delays between operations
-        std::thread([actor, armor, armorLight, equipManager, withShadows, trackedActor]() {
-            using namespace std::chrono_literals;
-            constexpr auto unequipWaitTime = 600ms;
-            constexpr auto enchantmentRespawnTime = 600ms;
-            uint32_t armorFormId = armor->GetFormID();
+        // Each step runs on the main thread its delay after the previous one
+        using namespace std::chrono_literals;
+        constexpr auto unequipWaitTime = 600ms;
+        constexpr auto enchantmentRespawnTime = 600ms;
+        uint32_t armorFormId = armor->GetFormID();
+
+        TaskScheduler::GetSingleton().ScheduleSequence({
+            // Unequip on the next tick
+            {0ms,
+             [actor, armor, equipManager]() {
+                 equipManager->UnequipObject(actor, armor, nullptr, 1, nullptr, false, false, false, false, nullptr);
+             }},
+            // Re-equip once the unequip completed
+            {unequipWaitTime,
+             [actor, armor, equipManager]() {
+                 equipManager->EquipObject(actor, armor, nullptr, 1, nullptr, false, false, false, false);
+             }},
+            // Restore the base form once the enchantment respawned
+            {enchantmentRespawnTime,
+             [armorLight, armorFormId, trackedHandle]() {
+                 if (armorLight) {
+                     SetLightTypeNative(armorLight, false);
+                 }
+                 if (auto* trackedActor = ActorTracker::GetSingleton().Resolve(trackedHandle)) {
+                     trackedActor->SetReEquipping(armorFormId, false);
+                 }
+                 InvalidateSceneSnapshot();
+             }},
+        });
+        return true;
+    }
 
-            // Unequip
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([actor, armor, equipManager]() {
-                    equipManager->UnequipObject(actor, armor, nullptr, 1, nullptr, false, false, false, false, nullptr);
-                });
-            }
+    /**
+     * Walks the actor's active effects once, calling `visitor` with each configured spell they belong to.
+     * Stops early if the visitor returns true.
+     */
+    template <class Visitor>
+    static void VisitActiveConfiguredSpells(RE::Actor* actor, Visitor&& visitor) {
+        if (!actor) return;
 
-            // Wait for unequip to complete
-            std::this_thread::sleep_for(unequipWaitTime);
+        auto* magicTarget = actor->GetMagicTarget();
+        if (!magicTarget) return;
 
-            // Re-equip
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([actor, armor, equipManager]() {
-                    equipManager->EquipObject(actor, armor, nullptr, 1, nullptr, false, false, false, false);
-                });
+        auto* activeEffects = magicTarget->GetActiveEffectList();
+        if (!activeEffects) return;
+
+        const auto& effectIndex = GetEffectSpellIndex();
+        for (auto* activeEffect : *activeEffects) {
+            // Expired and dispelled effects linger in the list until the game removes them
+            if (!activeEffect ||
+                activeEffect->flags.any(RE::ActiveEffect::Flag::kInactive, RE::ActiveEffect::Flag::kDispelled)) {
+                continue;
             }
 
-            // Wait for enchantment to respawn
-            std::this_thread::sleep_for(enchantmentRespawnTime);
-
-            // Restore base form
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([armorLight, armorFormId, trackedActor]() {
-                    if (armorLight) {
-                        SetLightTypeNative(armorLight, false);
-                    }
-                    trackedActor->SetReEquipping(false);
-                });
+            for (uint32_t spellFormId : effectIndex.Find(activeEffect->GetBaseObject())) {
+                if (visitor(spellFormId)) {
+                    return;
+                }
             }
-        }).detach();
+        }
     }
 
     /*
@@ -222,24 +252,25 @@ namespace ActorShadowLimiter {
     std::vector<uint32_t> GetActiveConfiguredSpells(RE::Actor* actor) {
         std::vector<uint32_t> activeSpells;
 
-        for (const auto& spellConfig : g_config.spells) {
-            auto* spell = RE::TESForm::LookupByID<RE::SpellItem>(spellConfig.formId);
-            if (!spell || spell->effects.size() == 0) continue;
-
-            // Check if any of this spell's effects are active
-            for (auto* effect : spell->effects) {
-                if (!effect || !effect->baseEffect) continue;
-
-                if (HasMagicEffect(actor, effect->baseEffect->GetFormID())) {
-                    activeSpells.push_back(spellConfig.formId);
-                    break;  // Found this spell active, move to next spell
-                }
+        VisitActiveConfiguredSpells(actor, [&activeSpells](uint32_t spellFormId) {
+            if (std::find(activeSpells.begin(), activeSpells.end(), spellFormId) == activeSpells.end()) {
+                activeSpells.push_back(spellFormId);
             }
-        }
+            return false;
+        });
 
         return activeSpells;
     }
 
+    bool IsConfiguredSpellActive(RE::Actor* actor, uint32_t spellFormId) {
+        bool isActive = false;
+        VisitActiveConfiguredSpells(actor, [&isActive, spellFormId](uint32_t activeSpellFormId) {
+            isActive = activeSpellFormId == spellFormId;
+            return isActive;
+        });
+        return isActive;
+    }
+
     /**
      * Check if actor has a configured hand-held light equipped
      */
@@ -250,10 +281,8 @@ namespace ActorShadowLimiter {
         uint32_t lightFormId = lightBase->GetFormID();
 
         // Check if this light is in our configuration
-        for (const auto& config : g_config.handHeldLights) {
-            if (config.formId == lightFormId) {
-                return lightFormId;
-            }
+        if (GetConfigRegistry().Find(lightFormId).AsHandHeldLight()) {
+            return lightFormId;
         }
 
         return std::nullopt;
@@ -276,72 +305,32 @@ namespace ActorShadowLimiter {
             if (!armor) continue;
 
             // Check if this armor is in our configuration
-            for (const auto& config : g_config.enchantedArmors) {
-                if (config.formId == armor->GetFormID()) {
-                    activeArmors.push_back(armor->GetFormID());
-                    break;
-                }
+            if (GetConfigRegistry().Find(armor->GetFormID()).AsEnchantedArmor()) {
+                activeArmors.push_back(armor->GetFormID());
             }
         }
 
         return activeArmors;
     }
 
-    /**
-     * Get the associated light from an enchanted armors enchantment.
-     */
-    RE::TESObjectLIGH* GetLightFromEnchantedArmor(RE::TESObjectARMO* armor) {
-        // Sanity checks
-        if (!armor) {
-            DebugPrint("WARN", "GetLightFromEnchantedArmor: armor is null");
-            return nullptr;
-        }
-        if (!armor->formEnchanting) {
-            DebugPrint("WARN", "Armor 0x%08X has no formEnchanting", armor->GetFormID());
-            return nullptr;
-        }
-        auto* enchantment = armor->formEnchanting;
-        if (enchantment->effects.size() == 0) {
-            DebugPrint("WARN", "Armor 0x%08X enchantment has no effects", armor->GetFormID());
-            return nullptr;
-        }
-
-        // Find the light-associated effect
-        for (auto* effect : enchantment->effects) {
-            // Effect sanity checks
-            if (!effect || !effect->baseEffect) continue;
-
-            auto* assocForm = effect->baseEffect->data.associatedForm;
-            if (!assocForm) {
-                DebugPrint("WARN", "Effect has no associated form");
-                continue;
-            }
-
-            // Check if the associated form is a light
-            auto* light = assocForm->As<RE::TESObjectLIGH>();
-            if (light) {
-                return light;
-            }
-        }
-
-        DebugPrint("WARN", "No light found in armor 0x%08X enchantment", armor->GetFormID());
-        return nullptr;
-    }
-
     /**
      * Count nearby shadow-casting lights.
      */
-    int CountNearbyShadowLights() {
+    static void ScanScene(SceneSnapshot& snapshot) {
+        snapshot = SceneSnapshot{};
+
         auto* player = RE::PlayerCharacter::GetSingleton();
         if (!player) {
-            return 0;
+            return;
         }
 
         auto* cell = player->GetParentCell();
         if (!cell) {
-            return 0;
+            return;
         }
         bool isInterior = cell->IsInteriorCell();
+        snapshot.cellFormId = cell->GetFormID();
+        snapshot.isInterior = isInterior;
         DebugPrint("DEBUG", "Starting cell scan on cell '%s'...", cell->GetFormEditorID());
 
         RE::NiPoint3 playerPos = player->GetPosition();
@@ -349,96 +338,132 @@ namespace ActorShadowLimiter {
         // Get the shadow scene node - contains all actively rendered shadow lights
         auto* smState = &RE::BSShaderManager::State::GetSingleton();
         if (!smState) {
-            return 0;
+            return;
         }
 
         auto* shadowSceneNode = smState->shadowSceneNode[0];
         if (!shadowSceneNode) {
-            return 0;
+            return;
         }
 
         int shadowLightCount = 0;
-        float closestLightDistance = std::numeric_limits<float>::max();
 
-        // Track counted lights by position and radius to avoid counting first/third person duplicates
-        struct CountedLight {
-            RE::NiPoint3 pos;
-            float radius;
-        };
-        std::vector<CountedLight> countedLights;
+        // Cluster counted lights by position and radius to avoid counting first/third person duplicates.
+        // Scans run on the main thread only, so one instance keeps its storage between them.
+        static LightClusters countedLights;
+        countedLights.Clear();
 
         // Get shadow distance from config (initialized from game INI settings)
-        float shadowDistance = isInterior ? g_config.shadowDistanceInterior : g_config.shadowDistanceExterior;
-
-        // Iterate through active shadow lights (already filtered by renderer)
+        const auto& config = GetConfig();
+        float shadowDistance = isInterior ? config.shadowDistanceInterior : config.shadowDistanceExterior;
+
+        // Gather positions and radii of the active shadow lights (already filtered by renderer)
+        static ShadowLightBatch batch;
+        static std::vector<RE::BSLight*> batchLights;
+        static std::vector<uint32_t> closestFirst;
+        batch.Clear();
+        batchLights.clear();
         auto& activeShadowLights = shadowSceneNode->GetRuntimeData().activeShadowLights;
         for (const auto& lightPtr : activeShadowLights) {
             if (auto* bsLight = lightPtr.get()) {
                 if (auto* niLight = bsLight->light.get()) {
-                    // Get light world position
-                    RE::NiPoint3 lightPos = niLight->world.translate;
-
-                    // Calculate distance from player
-                    float dx = lightPos.x - playerPos.x;
-                    float dy = lightPos.y - playerPos.y;
-                    float dz = lightPos.z - playerPos.z;
-                    float distSq = dx * dx + dy * dy + dz * dz;
-
-                    // Check if within search radius
-                    float distance = std::sqrt(distSq);
-
-                    // Get light radius from NiLight runtime data
-                    auto& radiusVec = niLight->GetLightRuntimeData().radius;
-                    float radius = radiusVec.x;
-
-                    // Effective shadow distance: light radius + game's shadow distance setting + config modifier
-                    float effectiveShadowDistance = radius + shadowDistance + g_config.shadowDistanceSafetyMargin;
-                    bool withinEffectiveShadowDist = distance <= effectiveShadowDistance;
-
-                    if (withinEffectiveShadowDist) {
-                        // Check position clustering to avoid counting first/third person duplicates
-                        bool isDuplicate = false;
-
-                        for (const auto& counted : countedLights) {
-                            float lx = lightPos.x - counted.pos.x;
-                            float ly = lightPos.y - counted.pos.y;
-                            float lz = lightPos.z - counted.pos.z;
-                            float posDiff = std::sqrt(lx * lx + ly * ly + lz * lz);
-
-                            // If within 50 units and same radius, consider it a duplicate
-                            if (posDiff < 100.0f && std::abs(radius - counted.radius) < 0.1f) {
-                                isDuplicate = true;
-                                DebugPrint("SCAN",
-                                           "Skipping duplicate light at (%.1f, %.1f, %.1f) - %.1f units from "
-                                           "already counted light",
-                                           lightPos.x, lightPos.y, lightPos.z, posDiff);
-                                break;
-                            }
-                        }
-
-                        if (!isDuplicate) {
-                            countedLights.push_back({lightPos, radius});
-                            DebugPrint("SCAN",
-                                       "Found shadow light - Pos: (%.1f, %.1f, %.1f), Distance: %.1f, Radius: %.1f, "
-                                       "EffectiveDist: %.1f",
-                                       lightPos.x, lightPos.y, lightPos.z, distance, radius, effectiveShadowDistance);
-                            ++shadowLightCount;
-                            if (distance < closestLightDistance) {
-                                closestLightDistance = distance;
-                            }
-                        }
-                    }
+                    batch.Push(niLight->world.translate, niLight->GetLightRuntimeData().radius.x);
+                    batchLights.push_back(bsLight);
                 }
             }
         }
 
+        // Effective shadow distance: light radius + game's shadow distance setting + config modifier,
+        // widened by the policy for lights already counted and lights about to come into reach
+        float extraDistance = shadowDistance + config.shadowDistanceSafetyMargin;
+        SelectCountedLights(batch, batchLights, playerPos, snapshot.cellFormId, extraDistance);
+        SortInRangeByDistance(batch, closestFirst);
+
+        // Nearest lights first, so of two duplicates the closer one is the one counted
+        for (uint32_t i : closestFirst) {
+            RE::NiPoint3 lightPos{batch.posX[i], batch.posY[i], batch.posZ[i]};
+            float radius = batch.radius[i];
+
+            float duplicateDistSq = 0.0f;
+            if (!countedLights.Add(lightPos, radius, &duplicateDistSq)) {
+                DebugPrint("SCAN",
+                           "Skipping duplicate light at (%.1f, %.1f, %.1f) - %.1f units from already counted light",
+                           lightPos.x, lightPos.y, lightPos.z, std::sqrt(duplicateDistSq));
+                continue;
+            }
+
+            DebugPrint("SCAN",
+                       "Found shadow light - Pos: (%.1f, %.1f, %.1f), Distance: %.1f, Radius: %.1f, EffectiveDist: %.1f",
+                       lightPos.x, lightPos.y, lightPos.z, std::sqrt(batch.distanceSq[i]), radius,
+                       radius + extraDistance);
+            if (shadowLightCount == 0) {
+                snapshot.closestLightDistance = std::sqrt(batch.distanceSq[i]);
+            }
+            ++shadowLightCount;
+        }
+        snapshot.shadowLightCount = shadowLightCount;
+
         auto& actorTracker = ActorTracker::GetSingleton();
         DebugPrint("SCAN", "%d shadow lights too close (total %d) where %d are tracked actors (total %d)",
                    shadowLightCount, activeShadowLights.size(), actorTracker.GetTrackedActorsWithShadowsCount(),
                    actorTracker.GetTrackedActorCount());
         DebugPrint("DEBUG", "End of cell scan.");
+    }
+
+    // Snapshot state is main thread only, invalidation may come from any thread
+    static SceneSnapshot g_sceneSnapshot;
+    static std::chrono::steady_clock::time_point g_sceneSnapshotTime;
+    static std::atomic<bool> g_sceneSnapshotValid{false};
+
+    const SceneSnapshot& GetSceneSnapshot() {
+        // Long enough to cover every evaluation a single frame triggers, short enough to track movement
+        constexpr auto kMaxSnapshotAge = std::chrono::milliseconds(100);
+
+        auto now = std::chrono::steady_clock::now();
+        uint32_t cellFormId = 0;
+        if (auto* player = RE::PlayerCharacter::GetSingleton()) {
+            if (auto* cell = player->GetParentCell()) {
+                cellFormId = cell->GetFormID();
+            }
+        }
+
+        if (!g_sceneSnapshotValid.exchange(true) || g_sceneSnapshot.cellFormId != cellFormId ||
+            now - g_sceneSnapshotTime > kMaxSnapshotAge) {
+            ScanScene(g_sceneSnapshot);
+            g_sceneSnapshotTime = now;
+        }
+        return g_sceneSnapshot;
+    }
+
+    void InvalidateSceneSnapshot() { g_sceneSnapshotValid = false; }
+
+    uint64_t GetShadowLightSetFingerprint(float positionBand) {
+        auto* smState = &RE::BSShaderManager::State::GetSingleton();
+        auto* shadowSceneNode = smState ? smState->shadowSceneNode[0] : nullptr;
+        if (!shadowSceneNode) {
+            return 0;
+        }
+
+        // Light identity plus its position in coarse bands, sorted so list order does not matter
+        static std::vector<std::pair<uint64_t, uint64_t>> entries;
+        entries.clear();
+        float inverseBand = 1.0f / std::max(positionBand, 1.0f);
+        auto band = [inverseBand](float value) {
+            return static_cast<uint64_t>(static_cast<int64_t>(std::floor(value * inverseBand))) & 0x1FFFFF;
+        };
+        for (const auto& lightPtr : shadowSceneNode->GetRuntimeData().activeShadowLights) {
+            if (auto* bsLight = lightPtr.get()) {
+                if (auto* niLight = bsLight->light.get()) {
+                    const auto& pos = niLight->world.translate;
+                    entries.emplace_back(reinterpret_cast<uintptr_t>(bsLight),
+                                         (band(pos.x) << 42) | (band(pos.y) << 21) | band(pos.z));
+                }
+            }
+        }
+        std::sort(entries.begin(), entries.end());
 
-        return shadowLightCount;
+        return Fnv1a64(std::string_view(reinterpret_cast<const char*>(entries.data()),
+                                        entries.size() * sizeof(entries[0])));
     }
 
 }
@@ -5,15 +5,39 @@
 namespace ActorShadowLimiter {
     RE::TESObjectLIGH* GetEquippedLight(RE::Actor* actor);
 
-    void ForceReEquipLight(RE::Actor* actor, RE::TESObjectLIGH* light, bool withShadows);
-    void ForceReEquipArmor(RE::Actor* actor, RE::TESObjectARMO* armor, bool withShadows);
-    void ForceCastSpell(RE::Actor* actor, RE::SpellItem* spell, bool withShadows, bool skipIfNotActive = true);
+    // Switch a light to its shadow or static variant. Return true if a transition was started, false if the
+    // light already had that state or could not be switched.
+    bool ForceReEquipLight(RE::Actor* actor, RE::TESObjectLIGH* light, bool withShadows);
+    bool ForceReEquipArmor(RE::Actor* actor, RE::TESObjectARMO* armor, bool withShadows);
+    bool ForceCastSpell(RE::Actor* actor, RE::SpellItem* spell, bool withShadows, bool skipIfNotActive = true);
 
-    int CountNearbyShadowLights();
+    /**
+     * Result of one scan of the active shadow lights around the player.
+     */
+    struct SceneSnapshot {
+        int shadowLightCount = 0;
+        float closestLightDistance = std::numeric_limits<float>::max();
+        bool isInterior = false;
+        uint32_t cellFormId = 0;
+    };
+
+    /**
+     * Shared scene scan, main thread only. Rescanned at most once per short time window unless the
+     * player changed cell or the snapshot was invalidated.
+     */
+    const SceneSnapshot& GetSceneSnapshot();
+
+    // Forces the next GetSceneSnapshot() to rescan, e.g. once one of our own light transitions restored its base form
+    void InvalidateSceneSnapshot();
+
+    /**
+     * Hash of which shadow lights are active and where, positions rounded to `positionBand` units.
+     * Equal values mean the renderer's shadow light set did not meaningfully change.
+     */
+    uint64_t GetShadowLightSetFingerprint(float positionBand);
 
     std::vector<uint32_t> GetActiveConfiguredSpells(RE::Actor* actor);
+    bool IsConfiguredSpellActive(RE::Actor* actor, uint32_t spellFormId);
     std::optional<uint32_t> GetActiveConfiguredLight(RE::Actor* actor);
     std::vector<uint32_t> GetActiveConfiguredEnchantedArmors(RE::Actor* actor);
-
-    RE::TESObjectLIGH* GetLightFromEnchantedArmor(RE::TESObjectARMO* armor);
 }
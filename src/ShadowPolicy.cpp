@@ -0,0 +1,147 @@
+#include "ShadowPolicy.h"
+
+#include <algorithm>
+#include <deque>
+#include <vector>
+
+#include "UpdateLogic.h"
+#include "core/Config.h"
+
+namespace ActorShadowLimiter {
+
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        // Velocities from samples closer than this are mostly noise once scaled up to the horizon
+        constexpr float kMinMotionSampleSeconds = 0.25f;
+        constexpr float kMaxMotionSampleSeconds = 10.0f;
+
+        // Extrapolating further than this guesses more than it predicts
+        constexpr float kMaxPredictionSeconds = 2.0f;
+
+        struct SeenLight {
+            RE::BSLight* light;
+            RE::NiPoint3 pos;
+
+            bool operator<(const SeenLight& other) const { return light < other.light; }
+        };
+
+        // Scan state carried to the next scan, main thread only
+        struct ScanHistory {
+            std::vector<RE::BSLight*> counted;  // Sorted
+            uint32_t cellFormId = 0;
+
+            // Motion reference, only replaced once enough time has passed to measure velocity
+            std::vector<SeenLight> lights;  // Sorted by light
+            RE::NiPoint3 playerPos;
+            Clock::time_point time{};
+        };
+
+        ScanHistory g_history;
+        std::deque<Clock::time_point> g_transitions;  // Main thread only
+        Clock::time_point g_lastTransition{};
+
+        float GetPredictionHorizonSeconds() {
+            const auto& config = GetConfig();
+            float interval = IsFrameUpdateActive() ? config.frameUpdateIntervalMs / 1000.0f
+                                                   : static_cast<float>(config.pollIntervalSeconds);
+            return std::clamp(interval, 0.0f, kMaxPredictionSeconds);
+        }
+
+        void PruneTransitions(Clock::time_point now) {
+            while (!g_transitions.empty() && now - g_transitions.front() > std::chrono::minutes(1)) {
+                g_transitions.pop_front();
+            }
+        }
+    }
+
+    void SelectCountedLights(ShadowLightBatch& batch, std::span<RE::BSLight* const> lights,
+                             const RE::NiPoint3& playerPos, uint32_t cellFormId, float extraDistance) {
+        const auto& config = GetConfig();
+        auto now = Clock::now();
+        size_t count = batch.Size();
+        bool sameCell = g_history.cellFormId == cellFormId;
+
+        static std::vector<uint8_t> counted;
+        counted.assign(count, 0);
+
+        // Prediction: count lights that will be inside the distance by the next evaluation
+        float sampleSeconds = std::chrono::duration<float>(now - g_history.time).count();
+        bool hasMotion = config.enableMotionPrediction && sameCell && sampleSeconds >= kMinMotionSampleSeconds &&
+                         sampleSeconds <= kMaxMotionSampleSeconds;
+        if (hasMotion) {
+            float scale = GetPredictionHorizonSeconds() / sampleSeconds;
+            RE::NiPoint3 predictedPlayer = playerPos + (playerPos - g_history.playerPos) * scale;
+
+            static ShadowLightBatch predicted;
+            predicted.Clear();
+            for (size_t i = 0; i < count; ++i) {
+                RE::NiPoint3 pos{batch.posX[i], batch.posY[i], batch.posZ[i]};
+                auto it = std::lower_bound(g_history.lights.begin(), g_history.lights.end(), SeenLight{lights[i], {}});
+                if (it != g_history.lights.end() && it->light == lights[i]) {
+                    pos = pos + (pos - it->pos) * scale;
+                }
+                predicted.Push(pos, batch.radius[i]);
+            }
+            EvaluateShadowDistances(predicted, predictedPlayer, extraDistance);
+            std::copy(predicted.inRange.begin(), predicted.inRange.end(), counted.begin());
+        }
+
+        // Hysteresis: lights counted last scan only drop out past the exit band
+        if (config.shadowHysteresisDistance > 0.0f && sameCell && !g_history.counted.empty()) {
+            EvaluateShadowDistances(batch, playerPos, extraDistance + config.shadowHysteresisDistance);
+            for (size_t i = 0; i < count; ++i) {
+                if (batch.inRange[i] &&
+                    std::binary_search(g_history.counted.begin(), g_history.counted.end(), lights[i])) {
+                    counted[i] = 1;
+                }
+            }
+        }
+
+        // Plain test last, so the batch is left with current distances
+        EvaluateShadowDistances(batch, playerPos, extraDistance);
+        for (size_t i = 0; i < count; ++i) {
+            batch.inRange[i] |= counted[i];
+        }
+
+        g_history.counted.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (batch.inRange[i]) {
+                g_history.counted.push_back(lights[i]);
+            }
+        }
+        std::sort(g_history.counted.begin(), g_history.counted.end());
+
+        if (!sameCell || sampleSeconds >= kMinMotionSampleSeconds) {
+            g_history.lights.clear();
+            for (size_t i = 0; i < count; ++i) {
+                g_history.lights.push_back({lights[i], {batch.posX[i], batch.posY[i], batch.posZ[i]}});
+            }
+            std::sort(g_history.lights.begin(), g_history.lights.end());
+            g_history.playerPos = playerPos;
+            g_history.time = now;
+        }
+        g_history.cellFormId = cellFormId;
+    }
+
+    void RecordShadowTransition(TrackedActor& actor) {
+        auto now = Clock::now();
+        actor.MarkTransition(now);
+        g_lastTransition = now;
+
+        g_transitions.push_back(now);
+        PruneTransitions(now);
+    }
+
+    Clock::time_point GetDwellCutoff() {
+        auto dwell = std::chrono::duration<float>(std::max(GetConfig().minShadowDwellSeconds, 0.0f));
+        return Clock::now() - std::chrono::duration_cast<Clock::duration>(dwell);
+    }
+
+    bool IsAnyActorDwelling() { return g_lastTransition > GetDwellCutoff(); }
+
+    size_t GetTransitionsPerMinute() {
+        PruneTransitions(Clock::now());
+        return g_transitions.size();
+    }
+}
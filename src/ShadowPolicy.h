@@ -0,0 +1,34 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <span>
+
+#include "RE/Skyrim.h"
+#include "actor/TrackedActor.h"
+#include "utils/ShadowDistanceKernel.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Decides which scanned shadow lights count against the budget. `batch` holds the lights of
+     * `lights` in the same order. On return `inRange` marks the counted lights and `distanceSq` holds
+     * current distances. On top of the plain effective distance test, lights counted by the previous
+     * scan stay counted until they leave a wider exit band, and lights that player and light motion
+     * carry inside the distance before the next evaluation are counted early. Main thread only.
+     */
+    void SelectCountedLights(ShadowLightBatch& batch, std::span<RE::BSLight* const> lights,
+                             const RE::NiPoint3& playerPos, uint32_t cellFormId, float extraDistance);
+
+    // Records a shadow switch made by the update policy, for dwell times and the transition rate
+    void RecordShadowTransition(TrackedActor& actor);
+
+    // Actors whose last transition is later than this are still within their minimum dwell time
+    std::chrono::steady_clock::time_point GetDwellCutoff();
+
+    // True while any actor is still within its dwell time, so a later evaluation can pick it up
+    bool IsAnyActorDwelling();
+
+    // Policy transitions over the last minute
+    size_t GetTransitionsPerMinute();
+}
@@ -1,22 +1,100 @@
 #include "UpdateLogic.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
 #include <chrono>
 #include <thread>
 
 #include "LightManager.h"
 #include "SKSE/SKSE.h"
+#include "ShadowPolicy.h"
 #include "actor/ActorTracker.h"
 #include "actor/TrackedActor.h"
 #include "core/Config.h"
+#include "core/ConfigStore.h"
 #include "core/Globals.h"
 #include "utils/Cleanup.h"
 #include "utils/Console.h"
+#include "utils/Hash.h"
 #include "utils/Helpers.h"
 #include "utils/Light.h"
 #include "utils/MagicEffect.h"
+#include "utils/TaskScheduler.h"
 
 namespace ActorShadowLimiter {
+    /**
+     * Switches one configured light, spell or armor of the actor to its shadow or static variant.
+     * Only switches that actually started count towards dwell times and the transition rate.
+     */
+    static void ApplyLightShadowState(RE::Actor* actor, RE::TESForm* form, bool withShadows) {
+        bool started = false;
+        if (IsHandheldLight(form)) {
+            started |= ForceReEquipLight(actor, form->As<RE::TESObjectLIGH>(), withShadows);
+        }
+        if (IsLightEmittingArmor(form)) {
+            started |= ForceReEquipArmor(actor, form->As<RE::TESObjectARMO>(), withShadows);
+        }
+        if (IsSpellLight(form)) {
+            started |= ForceCastSpell(actor, form->As<RE::SpellItem>(), withShadows);
+        }
+        if (!started) {
+            return;
+        }
+        if (auto* trackedActor = ActorTracker::GetSingleton().GetActor(actor->GetFormID())) {
+            RecordShadowTransition(*trackedActor);
+        }
+    }
+
+    // Ticks that ran a full evaluation and ticks skipped because nothing relevant changed
+    static std::atomic<uint64_t> g_evaluatedTicks{0};
+    static std::atomic<uint64_t> g_skippedTicks{0};
+
+    /**
+     * Returns false if nothing the evaluation depends on changed since the last full evaluation:
+     * the shadow light set, the player's cell and position band, the config and shadow limit, and the
+     * tracker's actor and light state counter. Only cheap values go in, so a skipped tick touches no
+     * tracked actor. NPCs walking in or out of range and actors that unloaded do not change it; the full
+     * evaluation forced every few ticks picks those up.
+     */
+    static bool HasSceneChanged(RE::TESObjectCELL* cell, RE::Actor* player) {
+        // Coarse enough that walking around a room does not count, fine enough that lights entering reach do
+        constexpr float kPositionBand = 256.0f;
+        constexpr uint32_t kMaxSkippedTicks = 6;
+
+        static uint64_t lastFingerprint = 0;
+        static uint32_t skippedInARow = 0;
+
+        uint64_t fingerprint = GetShadowLightSetFingerprint(kPositionBand);
+        auto mix = [&fingerprint](const auto& value) {
+            fingerprint = Fnv1a64(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), fingerprint);
+        };
+        auto pos = player->GetPosition();
+        mix(cell->GetFormID());
+        mix(GetConfigSnapshot().version);
+        mix(GetShadowLimit(cell));
+        mix(static_cast<int32_t>(std::floor(pos.x / kPositionBand)));
+        mix(static_cast<int32_t>(std::floor(pos.y / kPositionBand)));
+        mix(static_cast<int32_t>(std::floor(pos.z / kPositionBand)));
+        mix(ActorTracker::GetSingleton().GetStateEpoch());
+        mix(IsAnyActorDwelling());  // Flips once dwell times run out, so held back changes get evaluated
+
+        if (fingerprint == lastFingerprint && skippedInARow < kMaxSkippedTicks) {
+            ++skippedInARow;
+            return false;
+        }
+        lastFingerprint = fingerprint;
+        skippedInARow = 0;
+        return true;
+    }
+
+    double GetEvaluationSkipRatio() {
+        uint64_t skipped = g_skippedTicks.load(std::memory_order_relaxed);
+        uint64_t total = skipped + g_evaluatedTicks.load(std::memory_order_relaxed);
+        return total > 0 ? static_cast<double>(skipped) / static_cast<double>(total) : 0.0;
+    }
+
     bool EvaluateActorAndScene(RE::Actor* actor) {
         auto* origoActor = RE::PlayerCharacter::GetSingleton();
         if (!origoActor) {
@@ -38,129 +116,179 @@ namespace ActorShadowLimiter {
         }
 
         // Scan the scene - are we allowed to have shadows active?
-        int shadowLightCount = CountNearbyShadowLights();
+        int shadowLightCount = GetSceneSnapshot().shadowLightCount;
         int shadowLimit = GetShadowLimit(cell);
 
         return shadowLightCount < shadowLimit;
     }
 
-    void UpdateTrackedLights() {
-        // Sanity checks
+    /**
+     * One evaluation of all tracked actors, split into phases so the frame update can spread it over
+     * several frames. The poll thread runs every phase back to back.
+     */
+    struct UpdateCycle {
+        enum class Phase { Idle, EnforceRange, ApplyBudget };
+
+        Phase phase = Phase::Idle;
+        uint32_t cellFormId = 0;
+        std::vector<uint32_t> actorIds;
+        std::vector<uint32_t> inRangeActorIds;
+        size_t cursor = 0;  // Next entry of actorIds the range pass looks at
+    };
+
+    // Cell of the player if updates apply there, null otherwise
+    static RE::TESObjectCELL* GetUpdateCell() {
         // Note: Cleanup should be done in the CellListener, i.e. if the player moves from a valid to a non-valid cell.
         auto* origoActor = RE::PlayerCharacter::GetSingleton();
         if (!origoActor) {
-            return;
+            return nullptr;
         }
         auto* cell = origoActor->GetParentCell();
-        if (!IsValidCell(cell)) {
-            return;
+        return IsValidCell(cell) ? cell : nullptr;
+    }
+
+    /**
+     * Drops the actor from the tracker if it has no tracked light left or is no longer a valid actor.
+     * Returns the actor if it stays tracked, null if it was dropped.
+     */
+    static RE::Actor* RemoveIfInvalid(uint32_t actorFormId, TrackedActor* trackedActor) {
+        if (trackedActor && trackedActor->HasTrackedLight()) {
+            auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId);
+            if (actor && IsValidActor(actor)) {
+                return actor;
+            }
         }
+        ActorTracker::GetSingleton().RemoveActor(actorFormId);
+        return nullptr;
+    }
 
-        // First pass: Always enforce distance limits on all tracked actors
-        auto allTrackedActorIds = ActorTracker::GetSingleton().GetAllTrackedActorIds();
-        for (uint32_t actorFormId : allTrackedActorIds) {
-            auto* trackedActor = ActorTracker::GetSingleton().GetActor(actorFormId);
-            if (!trackedActor || !trackedActor->HasTrackedLight()) {
-                ActorTracker::GetSingleton().RemoveActor(actorFormId);
-                continue;
+    /**
+     * Decides whether this cycle needs to run at all and samples positions if it does. Returns false
+     * if the scene is unchanged since the last full evaluation. Actors that are gone are dropped by the
+     * range pass of the next evaluated cycle.
+     */
+    static bool BeginUpdateCycle(UpdateCycle& cycle, RE::TESObjectCELL* cell) {
+        auto* origoActor = RE::PlayerCharacter::GetSingleton();
+        if (!HasSceneChanged(cell, origoActor)) {
+            ++g_skippedTicks;
+            DebugPrint("UPDATE", "Scene unchanged, skipping evaluation (%.1f%% of ticks skipped)",
+                       GetEvaluationSkipRatio() * 100.0);
+            return false;
+        }
+        ++g_evaluatedTicks;
+
+        // Positions are sampled once here, every distance sort this cycle reads the cached keys
+        ActorTracker::GetSingleton().RefreshCachedPositions();
+
+        // Actors keep their shadows until past the exit band, enabling stays within NpcMaxDistance
+        cycle.inRangeActorIds = ActorTracker::GetSingleton().GetActorIdsInRange(GetConfig().GetNpcExitDistance());
+
+        cycle.phase = UpdateCycle::Phase::EnforceRange;
+        cycle.cellFormId = cell->GetFormID();
+        cycle.actorIds = ActorTracker::GetSingleton().GetAllTrackedActorIds();
+        cycle.cursor = 0;
+        return true;
+    }
+
+    /**
+     * First pass: Always enforce distance limits on all tracked actors. Resumes at the cycle's cursor
+     * and returns false if `deadline` passed before every actor was checked. At least one actor is
+     * checked per call, so a cycle always advances however small the budget.
+     */
+    static bool EnforceRangeLimits(UpdateCycle& cycle, std::chrono::steady_clock::time_point deadline) {
+        auto dwellCutoff = GetDwellCutoff();
+        for (bool first = true; cycle.cursor < cycle.actorIds.size(); first = false) {
+            if (!first && std::chrono::steady_clock::now() >= deadline) {
+                return false;
             }
+            uint32_t actorFormId = cycle.actorIds[cycle.cursor++];
 
-            auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId);
-            if (!actor || !IsValidActor(actor)) {
-                ActorTracker::GetSingleton().RemoveActor(actorFormId);
+            // Actors can go away while a frame-spread cycle is in progress
+            auto* trackedActor = ActorTracker::GetSingleton().GetActor(actorFormId);
+            auto* actor = RemoveIfInvalid(actorFormId, trackedActor);
+            if (!actor) {
                 continue;
             }
 
-            // Enforce distance limit: disable shadows for actors beyond max range
-            if (!IsActorWithinRange(actor)) {
-                auto trackedLight = trackedActor->GetTrackedLight();
-                if (trackedLight.has_value()) {
-                    uint32_t lightTypeFormId = trackedLight.value();
-                    if (trackedActor->GetLightShadowState(lightTypeFormId)) {
-                        auto* form = RE::TESForm::LookupByID<RE::TESForm>(lightTypeFormId);
-                        if (form) {
-                            DebugPrint("SCAN", actor, "Actor beyond max range, disabling shadows");
-                            if (IsHandheldLight(form)) {
-                                ForceReEquipLight(actor, form->As<RE::TESObjectLIGH>(), false);
-                            }
-                            if (IsLightEmittingArmor(form)) {
-                                ForceReEquipArmor(actor, form->As<RE::TESObjectARMO>(), false);
-                            }
-                            if (IsSpellLight(form)) {
-                                ForceCastSpell(actor, form->As<RE::SpellItem>(), false);
-                            }
-                        }
+            // Enforce distance limit: disable shadows on every light of actors beyond max range
+            if (!std::binary_search(cycle.inRangeActorIds.begin(), cycle.inRangeActorIds.end(), actorFormId) &&
+                trackedActor->GetLastTransitionTime() <= dwellCutoff) {
+                // Switching a light can remove it from the actor, or drop the actor along with its last light,
+                // so walk a copy rather than the actor's own light list
+                std::array<uint32_t, TrackedActor::kMaxTrackedLights> shadowedLights;
+                size_t shadowedCount = 0;
+                for (const auto& trackedLight : trackedActor->GetTrackedLights()) {
+                    if (trackedLight.hasShadows) {
+                        shadowedLights[shadowedCount++] = trackedLight.formId;
+                    }
+                }
+
+                for (size_t i = 0; i < shadowedCount; ++i) {
+                    if (auto* form = RE::TESForm::LookupByID<RE::TESForm>(shadowedLights[i])) {
+                        DebugPrint("SCAN", actor, "Actor beyond max range, disabling shadows on 0x%08X",
+                                   shadowedLights[i]);
+                        ApplyLightShadowState(actor, form, false);
                     }
                 }
             }
         }
+        return true;
+    }
 
+    /**
+     * Second half of a cycle: compares the scene against the shadow limit and switches the nearest or
+     * furthest lights to match. Not split by the frame budget: it selects at most as many lights as the
+     * scene is away from the limit, and each switch only schedules its transition.
+     */
+    static void ApplyShadowBudget(RE::TESObjectCELL* cell) {
         // Count nearby shadow-casting lights and determine if we want shadows enabled
-        int shadowLightCount = CountNearbyShadowLights();
+        int shadowLightCount = GetSceneSnapshot().shadowLightCount;
         int shadowLimit = GetShadowLimit(cell);
         bool shadowsAllowed = (shadowLightCount < shadowLimit);
 
-        // Second pass: Adjust NPC lights based on shadow limit
-        int actorCountToProcess = std::abs(shadowLightCount - shadowLimit);
-        if (actorCountToProcess > 0) {
-            // Sort actors by distance: closest first when enabling shadows, furthest first when disabling
-            auto trackedActorIds = ActorTracker::GetSingleton().GetAllTrackedActorIds(true, shadowsAllowed);
-            int processed = 0;
-
-            // Check all tracked actors and re-equip if needed
-            for (uint32_t actorFormId : trackedActorIds) {
-                if (processed >= actorCountToProcess) {
-                    break;
-                }
+        // Second pass: Adjust lights based on shadow limit, the budget is counted in lights not actors
+        int lightCountToProcess = std::abs(shadowLightCount - shadowLimit);
+        if (lightCountToProcess > 0) {
+            // Only the nearest (enabling) or furthest (disabling) lights that still need the change are selected.
+            // Enabling waits out each actor's dwell time, disabling over the limit never waits. Disabling searches
+            // the whole exit band, where actors still keep their shadows, so the furthest of them go first.
+            const auto& config = GetConfig();
+            auto changedBefore = shadowsAllowed ? GetDwellCutoff() : std::chrono::steady_clock::time_point::max();
+            float searchDistance = shadowsAllowed ? config.npcMaxDistance : config.GetNpcExitDistance();
+            auto candidates = ActorTracker::GetSingleton().SelectShadowCandidates(
+                static_cast<size_t>(lightCountToProcess), shadowsAllowed, shadowsAllowed, searchDistance,
+                changedBefore);
 
-                auto* trackedActor = ActorTracker::GetSingleton().GetActor(actorFormId);
-                if (!trackedActor || !trackedActor->HasTrackedLight()) {
+            for (const auto& candidate : candidates) {
+                auto* trackedActor = ActorTracker::GetSingleton().GetActor(candidate.actorFormId);
+                if (!trackedActor || !trackedActor->IsTrackingLight(candidate.lightFormId)) {
                     continue;
                 }
 
-                auto* actor = RE::TESForm::LookupByID<RE::Actor>(actorFormId);
+                auto* actor = RE::TESForm::LookupByID<RE::Actor>(candidate.actorFormId);
                 if (!actor || !IsValidActor(actor)) {
                     continue;
                 }
 
-                // Skip actors that are out of range (already handled in first pass)
-                if (!IsActorWithinRange(actor)) {
-                    continue;
-                }
-
-                auto trackedLight = trackedActor->GetTrackedLight();
-                if (!trackedLight.has_value()) {
-                    continue;
-                }
-
-                uint32_t lightFormId = trackedLight.value();
-                auto* form = RE::TESForm::LookupByID<RE::TESForm>(lightFormId);
+                auto* form = RE::TESForm::LookupByID<RE::TESForm>(candidate.lightFormId);
                 if (!form) {
                     continue;
                 }
 
                 // Regular shadow limit processing
-                bool isNewState = shadowsAllowed != trackedActor->GetLightShadowState(lightFormId);
-                if (isNewState) {
-                    DebugPrint("SCAN", actor, "State change required, changing light to: %s",
-                               shadowsAllowed ? "SHADOWS" : "STATIC");
-                    if (IsHandheldLight(form)) {
-                        ForceReEquipLight(actor, form->As<RE::TESObjectLIGH>(), shadowsAllowed);
-                    }
-                    if (IsLightEmittingArmor(form)) {
-                        ForceReEquipArmor(actor, form->As<RE::TESObjectARMO>(), shadowsAllowed);
-                    }
-                    if (IsSpellLight(form)) {
-                        ForceCastSpell(actor, form->As<RE::SpellItem>(), shadowsAllowed);
-                    }
-                    processed++;
+                if (shadowsAllowed != trackedActor->GetLightShadowState(candidate.lightFormId)) {
+                    DebugPrint("SCAN", actor, "State change required, changing light 0x%08X to: %s",
+                               candidate.lightFormId, shadowsAllowed ? "SHADOWS" : "STATIC");
+                    ApplyLightShadowState(actor, form, shadowsAllowed);
                 }
             }
         }
 
+        DebugPrint("UPDATE", "%zu shadow transitions in the last minute", GetTransitionsPerMinute());
+
         // Start duplicate removal thread if any actors have shadows enabled
         // The thread will auto-stop when no actors have shadows
-        if (g_config.enableDuplicateFix && shadowsAllowed && ActorTracker::GetSingleton().ContainsTrackedNpcs()) {
+        if (GetConfig().enableDuplicateFix && shadowsAllowed && ActorTracker::GetSingleton().ContainsTrackedNpcs()) {
             StartDuplicateRemovalThread();
         }
 
@@ -170,6 +298,65 @@ namespace ActorShadowLimiter {
         }
     }
 
+    void UpdateTrackedLights() {
+        auto* cell = GetUpdateCell();
+        if (!cell) {
+            return;
+        }
+
+        UpdateCycle cycle;
+        if (!BeginUpdateCycle(cycle, cell)) {
+            return;
+        }
+        EnforceRangeLimits(cycle, std::chrono::steady_clock::time_point::max());
+        ApplyShadowBudget(cell);
+    }
+
+    void RunFrameUpdate() {
+        static UpdateCycle cycle;
+        static std::chrono::steady_clock::time_point lastCycleStart;
+
+        auto* cell = GetUpdateCell();
+        if (!g_shouldPoll || !cell) {
+            cycle.phase = UpdateCycle::Phase::Idle;
+            return;
+        }
+
+        // A cycle started in another cell is stale, start over
+        if (cycle.phase != UpdateCycle::Phase::Idle && cycle.cellFormId != cell->GetFormID()) {
+            cycle.phase = UpdateCycle::Phase::Idle;
+        }
+
+        const auto& config = GetConfig();
+        auto now = std::chrono::steady_clock::now();
+        auto deadline = now + std::chrono::microseconds(config.frameUpdateBudgetMicroseconds);
+
+        if (cycle.phase == UpdateCycle::Phase::Idle) {
+            if (now - lastCycleStart < std::chrono::milliseconds(config.frameUpdateIntervalMs)) {
+                return;
+            }
+            lastCycleStart = now;
+            if (!BeginUpdateCycle(cycle, cell)) {
+                return;
+            }
+        }
+
+        if (cycle.phase == UpdateCycle::Phase::EnforceRange) {
+            if (!EnforceRangeLimits(cycle, deadline)) {
+                return;
+            }
+            cycle.phase = UpdateCycle::Phase::ApplyBudget;
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return;
+            }
+        }
+
+        ApplyShadowBudget(cell);
+        cycle.phase = UpdateCycle::Phase::Idle;
+    }
+
+    bool IsFrameUpdateActive() { return g_frameUpdateHookInstalled && GetConfig().enableFrameUpdate; }
+
     void StartShadowPollThread() {
         // Atomic, thread-safe check if thread is already running
         bool expected = false;
@@ -180,13 +367,15 @@ namespace ActorShadowLimiter {
         std::thread([]() {
             using namespace std::chrono_literals;
             while (g_pollThreadRunning) {
-                std::this_thread::sleep_for(std::chrono::seconds(g_config.pollIntervalSeconds));
+                std::this_thread::sleep_for(std::chrono::seconds(AcquireConfigSnapshot()->config.pollIntervalSeconds));
                 // Check again after sleep in case flag was set during sleep
                 if (!g_pollThreadRunning) {
                     break;
                 }
-                // Only poll if we should be polling
-                if (g_shouldPoll) {
+                // Only poll if we should be polling, and the frame update is not doing it already
+                bool frameUpdateActive =
+                    g_frameUpdateHookInstalled && AcquireConfigSnapshot()->config.enableFrameUpdate;
+                if (g_shouldPoll && !frameUpdateActive) {
                     if (auto* tasks = SKSE::GetTaskInterface()) {
                         tasks->AddTask([]() { UpdateTrackedLights(); });
                     }
@@ -194,29 +383,22 @@ namespace ActorShadowLimiter {
             }
             DebugPrint("UPDATE", "Shadow poll thread stopped");
         }).detach();
-        DebugPrint("UPDATE", "Shadow poll thread started (%ds interval)", g_config.pollIntervalSeconds);
+        DebugPrint("UPDATE", "Shadow poll thread started (%ds interval)", GetConfig().pollIntervalSeconds);
     }
 
     /**
      * Tries to enable polling, if not already enabled.
      */
     void EnablePolling(int delayInSeconds) {
-        // Delay polling start by 4 seconds on a background thread, then execute on main thread
-        std::thread([=]() {
-            std::this_thread::sleep_for(std::chrono::seconds(delayInSeconds));
-
-            auto* taskQueue = SKSE::GetTaskInterface();
-            if (taskQueue) {
-                taskQueue->AddTask([]() {
-                    // Start polling if it's not already running
-                    if (!g_shouldPoll) {
-                        DebugPrint("UPDATE", "Enabling shadow polling");
-                        g_shouldPoll = true;
-                        StartShadowPollThread();
-                    }
-                });
+        // Delay polling start, then execute on main thread
+        TaskScheduler::GetSingleton().Schedule(std::chrono::seconds(delayInSeconds), []() {
+            // Start polling if it's not already running
+            if (!g_shouldPoll) {
+                DebugPrint("UPDATE", "Enabling shadow polling");
+                g_shouldPoll = true;
+                StartShadowPollThread();
             }
-        }).detach();
+        });
     }
 
     void StopShadowPollThread() {
@@ -11,6 +11,18 @@ namespace ActorShadowLimiter {
      */
     void UpdateTrackedLights();
 
+    /**
+     * Per-frame variant of UpdateTrackedLights, called from the frame update hook on the main thread.
+     * Spreads one update cycle over as many frames as the configured time budget requires.
+     */
+    void RunFrameUpdate();
+
+    // True when the frame update hook drives updates and the poll thread should stay idle
+    bool IsFrameUpdateActive();
+
+    // Share of UpdateTrackedLights ticks skipped because the scene had not changed, 0 to 1
+    double GetEvaluationSkipRatio();
+
     /**
      * Evaluate the scene and returns wether shadows can be applied or not.
      */
@@ -0,0 +1,56 @@
+#include "ActorGrid.h"
+
+namespace ActorShadowLimiter {
+
+    void ActorGrid::Reset(float cellSize, uint32_t maxIds) {
+        cellSize_ = std::max(cellSize, 1.0f);
+        inverseCellSize_ = 1.0f / cellSize_;
+
+        cells_.Clear();
+        count_ = 0;
+
+        next_.resize(maxIds);
+        positions_.resize(maxIds);
+        inGrid_.assign(maxIds, 0);
+    }
+
+    void ActorGrid::Insert(uint32_t id, const RE::NiPoint3& pos) {
+        if (id >= inGrid_.size()) {
+            return;
+        }
+        if (inGrid_[id]) {
+            // A recycled tracker slot now belongs to another actor, nothing of the old position may remain
+            if (KeyOf(positions_[id]) == KeyOf(pos)) {
+                positions_[id] = pos;
+                return;
+            }
+            Remove(id);
+        }
+
+        auto& head = cells_.Insert(KeyOf(pos));
+        positions_[id] = pos;
+        next_[id] = head;
+        head = id;
+        inGrid_[id] = 1;
+        ++count_;
+    }
+
+    void ActorGrid::Remove(uint32_t id) {
+        if (id >= inGrid_.size() || !inGrid_[id]) {
+            return;
+        }
+
+        uint64_t key = KeyOf(positions_[id]);
+        uint32_t* link = cells_.Lookup(key);
+        while (*link != id) {
+            link = &next_[*link];
+        }
+        *link = next_[id];
+        if (cells_.Find(key) == kEnd) {
+            cells_.Erase(key);
+        }
+
+        inGrid_[id] = 0;
+        --count_;
+    }
+}
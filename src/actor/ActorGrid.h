@@ -0,0 +1,117 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "../utils/CellTable.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Uniform 3D grid over small integer IDs (tracker slot indices). Cells live in a CellTable and
+     * each holds an intrusive list through `next_`, so a rebuild is O(n) and reuses its
+     * storage. Queries only visit cells overlapping the search volume.
+     */
+    class ActorGrid {
+    public:
+        void Reset(float cellSize, uint32_t maxIds);
+        void Insert(uint32_t id, const RE::NiPoint3& pos);  // Moves the ID if it is already in the grid
+        void Remove(uint32_t id);
+        bool Contains(uint32_t id) const { return id < inGrid_.size() && inGrid_[id]; }
+        size_t Size() const { return count_; }
+
+        /**
+         * Calls `fn(id, distanceSq)` for every ID within `radius` of `center`.
+         */
+        template <class Fn>
+        void ForEachInRange(const RE::NiPoint3& center, float radius, Fn&& fn) const {
+            if (count_ == 0) return;
+
+            float radiusSq = radius * radius;
+            int32_t minX = CellCoord(center.x - radius), maxX = CellCoord(center.x + radius);
+            int32_t minY = CellCoord(center.y - radius), maxY = CellCoord(center.y + radius);
+            int32_t minZ = CellCoord(center.z - radius), maxZ = CellCoord(center.z + radius);
+            for (int32_t x = minX; x <= maxX; ++x) {
+                for (int32_t y = minY; y <= maxY; ++y) {
+                    for (int32_t z = minZ; z <= maxZ; ++z) {
+                        VisitCell(x, y, z, center, [&](uint32_t id, float distanceSq) {
+                            if (distanceSq <= radiusSq) fn(id, distanceSq);
+                        });
+                    }
+                }
+            }
+        }
+
+        /**
+         * Up to `count` IDs passing `filter(id)` nearest to `center` and within `maxRadius`, closest first.
+         * Searches outwards one shell of cells at a time and stops once no unvisited cell can be closer.
+         */
+        template <class Filter>
+        void FindNearest(const RE::NiPoint3& center, size_t count, float maxRadius, Filter&& filter,
+                         std::vector<std::pair<float, uint32_t>>& out) const {
+            out.clear();
+            if (count == 0 || count_ == 0) return;
+
+            auto farther = [](const auto& a, const auto& b) { return a.first < b.first; };  // Max-heap on distance
+            float maxRadiusSq = maxRadius * maxRadius;
+            int32_t cx = CellCoord(center.x), cy = CellCoord(center.y), cz = CellCoord(center.z);
+            int32_t maxShell = static_cast<int32_t>(std::ceil(maxRadius / cellSize_));
+
+            for (int32_t shell = 0; shell <= maxShell; ++shell) {
+                for (int32_t dx = -shell; dx <= shell; ++dx) {
+                    for (int32_t dy = -shell; dy <= shell; ++dy) {
+                        // Interior of the shell was visited already, only its faces remain
+                        bool onFace = std::abs(dx) == shell || std::abs(dy) == shell;
+                        int32_t step = onFace ? 1 : std::max(1, 2 * shell);
+                        for (int32_t dz = -shell; dz <= shell; dz += step) {
+                            VisitCell(cx + dx, cy + dy, cz + dz, center, [&](uint32_t id, float distanceSq) {
+                                if (distanceSq > maxRadiusSq || !filter(id)) return;
+                                if (out.size() < count) {
+                                    out.emplace_back(distanceSq, id);
+                                    std::push_heap(out.begin(), out.end(), farther);
+                                } else if (distanceSq < out.front().first) {
+                                    std::pop_heap(out.begin(), out.end(), farther);
+                                    out.back() = {distanceSq, id};
+                                    std::push_heap(out.begin(), out.end(), farther);
+                                }
+                            });
+                        }
+                    }
+                }
+
+                // Anything beyond this shell is at least `shell` cells away from the center point
+                float bound = static_cast<float>(shell) * cellSize_;
+                if (out.size() == count && out.front().first <= bound * bound) break;
+            }
+            std::sort_heap(out.begin(), out.end(), farther);
+        }
+
+    private:
+        static constexpr uint32_t kEnd = UINT32_MAX;
+
+        int32_t CellCoord(float value) const { return static_cast<int32_t>(std::floor(value * inverseCellSize_)); }
+        uint64_t KeyOf(const RE::NiPoint3& pos) const {
+            return PackCellKey(CellCoord(pos.x), CellCoord(pos.y), CellCoord(pos.z));
+        }
+
+        template <class Fn>
+        void VisitCell(int32_t x, int32_t y, int32_t z, const RE::NiPoint3& center, Fn&& fn) const {
+            for (uint32_t id = cells_.Find(PackCellKey(x, y, z)); id != kEnd; id = next_[id]) {
+                const auto& pos = positions_[id];
+                float dx = pos.x - center.x, dy = pos.y - center.y, dz = pos.z - center.z;
+                fn(id, dx * dx + dy * dy + dz * dz);
+            }
+        }
+
+        float cellSize_ = 1.0f;
+        float inverseCellSize_ = 1.0f;
+        CellTable<uint32_t, kEnd> cells_;  // Head of each cell's list
+        size_t count_ = 0;
+        std::vector<uint32_t> next_;
+        std::vector<RE::NiPoint3> positions_;
+        std::vector<uint8_t> inGrid_;
+    };
+}
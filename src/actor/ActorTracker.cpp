@@ -2,6 +2,9 @@
 
 #include <algorithm>
 
+#include "../core/Config.h"
+#include "../utils/Console.h"
+
 namespace ActorShadowLimiter {
 
     ActorTracker& ActorTracker::GetSingleton() {
@@ -9,147 +12,557 @@ namespace ActorShadowLimiter {
         return instance;
     }
 
-    TrackedActor* ActorTracker::GetOrCreateActor(uint32_t actorFormId) {
-        std::lock_guard<std::mutex> lock(mutex_);
+    void ActorTracker::BindToMainThread() { mainThread_ = std::this_thread::get_id(); }
 
-        // Try to find existing actor
-        auto it = trackedActors_.find(actorFormId);
-        if (it != trackedActors_.end()) {
-            return &it->second;
+    bool ActorTracker::IsActorAccessAllowed() const {
+        if (mainThread_ == std::thread::id{} || std::this_thread::get_id() == mainThread_) {
+            return true;
+        }
+        if (!wrongThreadReported_.exchange(true, std::memory_order_relaxed)) {
+            SKSE::log::error("Tracked actors were accessed off the main thread, the access was refused");
         }
+        return false;
+    }
 
-        // Create new actor
-        auto result = trackedActors_.emplace(actorFormId, TrackedActor(actorFormId));
-        return &result.first->second;
+    namespace {
+        uint64_t PackIndexEntry(uint32_t actorFormId, uint32_t index) {
+            return (static_cast<uint64_t>(actorFormId) << 32) | index;
+        }
+        uint32_t IndexEntryFormId(uint64_t entry) { return static_cast<uint32_t>(entry >> 32); }
+        uint32_t IndexEntrySlot(uint64_t entry) { return static_cast<uint32_t>(entry); }
     }
 
-    void ActorTracker::AddActor(uint32_t actorFormId) {
-        std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t ActorTracker::IndexSlot(uint32_t actorFormId) {
+        // Fibonacci hashing, as in the config registry
+        return static_cast<uint32_t>((static_cast<uint64_t>(actorFormId) * 0x9E3779B97F4A7C15ull) >> 32) &
+               (kIndexCapacity - 1);
+    }
 
-        // Only add if actor doesn't already exist
-        if (trackedActors_.find(actorFormId) == trackedActors_.end()) {
-            trackedActors_.emplace(actorFormId, TrackedActor(actorFormId));
+    ActorHandle ActorTracker::VerifyHandle(uint32_t index, uint32_t actorFormId) const {
+        // Re-check the form ID so a slot removed and reused mid-read is not handed out
+        uint32_t generation = slots_[index].generation.load(std::memory_order_acquire);
+        if ((generation & 1) && slotFormIds_[index].load(std::memory_order_acquire) == actorFormId) {
+            return {index, generation};
         }
+        return {};
     }
 
-    TrackedActor* ActorTracker::GetActor(uint32_t actorFormId) {
-        std::lock_guard<std::mutex> lock(mutex_);
+    ActorHandle ActorTracker::ScanHandle(uint32_t actorFormId) const {
+        uint32_t count = slotCount_.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (slotFormIds_[i].load(std::memory_order_acquire) == actorFormId) {
+                if (auto handle = VerifyHandle(i, actorFormId)) {
+                    return handle;
+                }
+            }
+        }
+        return {};
+    }
 
-        auto it = trackedActors_.find(actorFormId);
-        if (it != trackedActors_.end()) {
-            return &it->second;
+    ActorHandle ActorTracker::FindHandle(uint32_t actorFormId) const {
+        if (actorFormId == 0 || actorFormId == kTombstoneFormId) {
+            return {};
         }
 
-        return nullptr;
+        uint32_t version = indexVersion_.load(std::memory_order_acquire);
+        if (!(version & 1)) {
+            for (uint32_t i = IndexSlot(actorFormId);; i = (i + 1) & (kIndexCapacity - 1)) {
+                uint64_t entry = index_[i].load(std::memory_order_acquire);
+                if (entry == 0) {
+                    break;
+                }
+                if (IndexEntryFormId(entry) == actorFormId) {
+                    return VerifyHandle(IndexEntrySlot(entry), actorFormId);
+                }
+            }
+
+            // A miss only counts if no rebuild ran meanwhile
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (indexVersion_.load(std::memory_order_relaxed) == version) {
+                return {};
+            }
+        }
+        return ScanHandle(actorFormId);
     }
 
-    bool ActorTracker::HasActor(uint32_t actorFormId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return trackedActors_.find(actorFormId) != trackedActors_.end();
+    void ActorTracker::IndexPlace(uint32_t actorFormId, uint32_t index) {
+        for (uint32_t i = IndexSlot(actorFormId);; i = (i + 1) & (kIndexCapacity - 1)) {
+            uint64_t entry = index_[i].load(std::memory_order_relaxed);
+            if (entry == 0 || IndexEntryFormId(entry) == kTombstoneFormId) {
+                if (entry == 0) {
+                    ++indexUsed_;
+                }
+                index_[i].store(PackIndexEntry(actorFormId, index), std::memory_order_release);
+                return;
+            }
+        }
     }
 
-    void ActorTracker::RemoveActor(uint32_t actorFormId) {
-        std::lock_guard<std::mutex> lock(mutex_);
-        trackedActors_.erase(actorFormId);
+    void ActorTracker::IndexInsert(uint32_t actorFormId, uint32_t index) {
+        // Tombstones lengthen probes, reclaim them before the table passes 3/4
+        // The slot's form ID is published before this, so a rebuild has already placed it
+        if (indexUsed_ + 1 > kIndexCapacity / 4 * 3) {
+            RebuildIndex();
+            return;
+        }
+        IndexPlace(actorFormId, index);
     }
 
-    void ActorTracker::ClearAllActors() {
-        std::lock_guard<std::mutex> lock(mutex_);
-        trackedActors_.clear();
+    void ActorTracker::IndexRemove(uint32_t actorFormId) {
+        for (uint32_t i = IndexSlot(actorFormId);; i = (i + 1) & (kIndexCapacity - 1)) {
+            uint64_t entry = index_[i].load(std::memory_order_relaxed);
+            if (entry == 0) {
+                return;
+            }
+            if (IndexEntryFormId(entry) == actorFormId) {
+                index_[i].store(PackIndexEntry(kTombstoneFormId, 0), std::memory_order_release);
+                return;
+            }
+        }
     }
 
-    std::vector<uint32_t> ActorTracker::GetAllTrackedActorIds(bool sortByDistance, bool closestFirst) const {
-        std::lock_guard<std::mutex> lock(mutex_);
+    void ActorTracker::RebuildIndex() {
+        // Seqlock write side, readers that saw the odd version or a changed one scan the slots instead
+        indexVersion_.store(indexVersion_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
 
-        std::vector<uint32_t> actorIds;
-        actorIds.reserve(trackedActors_.size());
+        for (auto& entry : index_) {
+            entry.store(0, std::memory_order_relaxed);
+        }
+        indexUsed_ = 0;
+        uint32_t count = slotCount_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (uint32_t actorFormId = slotFormIds_[i].load(std::memory_order_relaxed)) {
+                IndexPlace(actorFormId, i);
+            }
+        }
+
+        indexVersion_.store(indexVersion_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    TrackedActor* ActorTracker::Resolve(ActorHandle handle) {
+        return const_cast<TrackedActor*>(ResolveConst(handle));
+    }
+
+    const TrackedActor* ActorTracker::ResolveConst(ActorHandle handle) const {
+        if (!handle || handle.index >= kMaxTrackedActors || !IsActorAccessAllowed()) {
+            return nullptr;
+        }
+
+        const auto& slot = slots_[handle.index];
+        if (slot.generation.load(std::memory_order_acquire) != handle.generation) {
+            return nullptr;
+        }
+        return &slot.actor;
+    }
+
+    ActorHandle ActorTracker::GetOrCreateHandle(uint32_t actorFormId) {
+        if (!IsActorAccessAllowed()) {
+            return {};
+        }
+        if (actorFormId == 0 || actorFormId == kTombstoneFormId) {
+            return {};
+        }
+        if (auto handle = FindHandle(actorFormId)) {
+            return handle;
+        }
+
+        std::lock_guard<std::mutex> lock(writeMutex_);
+
+        // Another writer may have added it while we waited
+        if (auto handle = FindHandle(actorFormId)) {
+            return handle;
+        }
+
+        uint32_t index;
+        if (!freeSlots_.empty()) {
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            index = slotCount_.load(std::memory_order_relaxed);
+            if (index >= kMaxTrackedActors) {
+                // Logged regardless of EnableDebug, refused actors silently miss out on the shadow budget otherwise
+                if (!fullReported_) {
+                    fullReported_ = true;
+                    SKSE::log::error("Actor tracker is full ({} actors), further actors are not tracked",
+                                     kMaxTrackedActors);
+                }
+                DebugPrint("WARN", "Actor tracker full (%u actors), not tracking 0x%08X", kMaxTrackedActors,
+                           actorFormId);
+                return {};
+            }
+        }
 
-        for (const auto& [actorFormId, actor] : trackedActors_) {
-            actorIds.push_back(actorFormId);
+        // Publish the actor before its form ID, so a reader that finds the ID sees a live slot
+        auto& slot = slots_[index];
+        slot.actor = TrackedActor(actorFormId);
+        slot.actor.AttachAggregates(&aggregates_);
+        uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        slotFormIds_[index].store(actorFormId, std::memory_order_release);
+        if (index == slotCount_.load(std::memory_order_relaxed)) {
+            slotCount_.store(index + 1, std::memory_order_release);
         }
+        IndexInsert(actorFormId, index);
+        pendingSlots_.push_back(index);
 
-        // Sort by distance if requested
-        if (sortByDistance) {
-            auto* player = RE::PlayerCharacter::GetSingleton();
-            if (player) {
-                RE::NiPoint3 playerPos = player->GetPosition();
+        return {index, generation};
+    }
 
-                std::sort(actorIds.begin(), actorIds.end(), [&playerPos, closestFirst](uint32_t a, uint32_t b) {
-                    auto* actorA = RE::TESForm::LookupByID<RE::Actor>(a);
-                    auto* actorB = RE::TESForm::LookupByID<RE::Actor>(b);
+    TrackedActor* ActorTracker::GetOrCreateActor(uint32_t actorFormId) {
+        return Resolve(GetOrCreateHandle(actorFormId));
+    }
 
-                    if (!actorA) return false;
-                    if (!actorB) return true;
+    void ActorTracker::AddActor(uint32_t actorFormId) { GetOrCreateHandle(actorFormId); }
+
+    TrackedActor* ActorTracker::GetActor(uint32_t actorFormId) { return Resolve(FindHandle(actorFormId)); }
+
+    bool ActorTracker::HasActor(uint32_t actorFormId) const { return static_cast<bool>(FindHandle(actorFormId)); }
+
+    void ActorTracker::RemoveSlot(uint32_t index) {
+        // The actor object stays in place and is overwritten by the next actor given this slot
+        slots_[index].actor.DetachAggregates();
+        IndexRemove(slotFormIds_[index].load(std::memory_order_relaxed));
+        slotFormIds_[index].store(0, std::memory_order_release);
+        slots_[index].generation.fetch_add(1, std::memory_order_acq_rel);
+        freeSlots_.push_back(index);
+        fullReported_ = false;
+    }
+
+    void ActorTracker::RemoveActor(uint32_t actorFormId) {
+        if (!IsActorAccessAllowed()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        if (auto handle = FindHandle(actorFormId)) {
+            RemoveSlot(handle.index);
+        }
+    }
 
-                    RE::NiPoint3 posA = actorA->GetPosition();
-                    RE::NiPoint3 posB = actorB->GetPosition();
+    void ActorTracker::RemoveActorLight(uint32_t actorFormId, uint32_t lightFormId) {
+        if (!IsActorAccessAllowed()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        auto handle = FindHandle(actorFormId);
+        if (!handle) {
+            return;
+        }
 
-                    float distA = playerPos.GetSquaredDistance(posA);
-                    float distB = playerPos.GetSquaredDistance(posB);
+        auto& actor = slots_[handle.index].actor;
+        actor.RemoveLight(lightFormId);
+        if (!actor.HasTrackedLight()) {
+            RemoveSlot(handle.index);
+        }
+    }
 
-                    return closestFirst ? (distA < distB) : (distA > distB);
-                });
+    void ActorTracker::ClearAllActors() {
+        if (!IsActorAccessAllowed()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        uint32_t count = slotCount_.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (slots_[i].generation.load(std::memory_order_relaxed) & 1) {
+                RemoveSlot(i);
             }
         }
+    }
 
-        return actorIds;
+    void ActorTracker::RefreshCachedSlot(uint32_t index, uint32_t generation, const RE::NiPoint3& playerPos) {
+        auto& cache = positionCache_;
+        cache.generation[index] = generation;
+        cache.flags[index] = 0;
+
+        const auto& tracked = slots_[index].actor;
+        auto* actor = RE::TESForm::LookupByID<RE::Actor>(slotFormIds_[index].load(std::memory_order_acquire));
+        if (!actor) {
+            grid_.Remove(index);  // The slot may still hold a previous actor's entry
+            return;
+        }
+
+        RE::NiPoint3 pos = actor->GetPosition();
+        cache.posX[index] = pos.x;
+        cache.posY[index] = pos.y;
+        cache.posZ[index] = pos.z;
+        cache.distanceSq[index] = playerPos.GetSquaredDistance(pos);
+        cache.flags[index] = kCachedValid | (tracked.HasTrackedLight() ? kCachedHasLight : 0) |
+                             (tracked.HasAnyLightWithShadows() ? kCachedHasShadows : 0);
+        grid_.Insert(index, pos);
     }
 
-    size_t ActorTracker::GetTrackedActorCount() const {
-        std::lock_guard<std::mutex> lock(mutex_);
-        return trackedActors_.size();
+    void ActorTracker::RefreshPendingSlots() {
+        pendingScratch_.clear();
+        {
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            pendingScratch_.swap(pendingSlots_);
+        }
+        if (pendingScratch_.empty()) {
+            return;
+        }
+
+        for (uint32_t index : pendingScratch_) {
+            uint32_t generation = slots_[index].generation.load(std::memory_order_acquire);
+            if ((generation & 1) && positionCache_.generation[index] != generation) {
+                RefreshCachedSlot(index, generation, cachedPlayerPos_);
+            }
+        }
     }
 
-    size_t ActorTracker::GetTrackedActorsWithShadowsCount() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+    bool ActorTracker::IsCachedLive(uint32_t index) const {
+        uint32_t generation = slots_[index].generation.load(std::memory_order_acquire);
+        return (generation & 1) && positionCache_.generation[index] == generation &&
+               (positionCache_.flags[index] & kCachedValid);
+    }
 
-        size_t count = 0;
-        for (const auto& [actorFormId, actor] : trackedActors_) {
-            if (actor.HasAnyLightWithShadows()) {
-                ++count;
+    void ActorTracker::RefreshCachedPositions() {
+        auto* player = RE::PlayerCharacter::GetSingleton();
+        if (!player) {
+            return;
+        }
+        RE::NiPoint3 playerPos = player->GetPosition();
+        cachedPlayerPos_ = playerPos;
+
+        // A few cells across the range keeps range queries to a handful of cells per axis
+        constexpr float kGridCellsPerRange = 4.0f;
+        grid_.Reset(GetConfig().npcMaxDistance / kGridCellsPerRange, kMaxTrackedActors);
+        {
+            // Every live slot is refreshed below, including the pending ones
+            std::lock_guard<std::mutex> lock(writeMutex_);
+            pendingSlots_.clear();
+        }
+
+        uint32_t count = slotCount_.load(std::memory_order_acquire);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t generation = slots_[i].generation.load(std::memory_order_acquire);
+            if (generation & 1) {
+                RefreshCachedSlot(i, generation, playerPos);
+            } else {
+                positionCache_.generation[i] = 0;
             }
         }
-        return count;
     }
 
-    void ActorTracker::SetActorLightShadowState(uint32_t actorFormId, uint32_t lightFormId, bool hasShadows) {
-        auto* actor = GetOrCreateActor(actorFormId);
-        if (actor) {
-            actor->SetLightShadowState(lightFormId, hasShadows);
+    template <class Filter>
+    std::vector<ActorTracker::DistanceKey> ActorTracker::GatherDistanceKeys(Filter&& filter) {
+        std::vector<DistanceKey> keys;
+
+        auto* player = RE::PlayerCharacter::GetSingleton();
+        RE::NiPoint3 playerPos = player ? player->GetPosition() : RE::NiPoint3{};
+
+        uint32_t count = slotCount_.load(std::memory_order_acquire);
+        keys.reserve(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            uint32_t generation = slots_[i].generation.load(std::memory_order_acquire);
+            uint32_t actorFormId = slotFormIds_[i].load(std::memory_order_acquire);
+            if (!(generation & 1) || actorFormId == 0) {
+                continue;
+            }
+            if (!filter(slots_[i].actor)) {
+                continue;
+            }
+
+            // Actors tracked since the last refresh get a one-off lookup
+            if (positionCache_.generation[i] != generation && player) {
+                RefreshCachedSlot(i, generation, playerPos);
+            }
+
+            bool valid = positionCache_.generation[i] == generation && (positionCache_.flags[i] & kCachedValid);
+            keys.push_back({actorFormId, i, positionCache_.distanceSq[i], valid});
         }
+        return keys;
     }
 
-    std::optional<bool> ActorTracker::GetActorLightShadowState(uint32_t actorFormId, uint32_t lightFormId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t> ActorTracker::GetAllTrackedActorIds(bool sortByDistance, bool closestFirst) {
+        std::vector<uint32_t> actorIds;
+
+        if (!sortByDistance || !RE::PlayerCharacter::GetSingleton()) {
+            uint32_t count = slotCount_.load(std::memory_order_acquire);
+            actorIds.reserve(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                if (uint32_t actorFormId = slotFormIds_[i].load(std::memory_order_acquire)) {
+                    actorIds.push_back(actorFormId);
+                }
+            }
 
-        auto it = trackedActors_.find(actorFormId);
-        if (it != trackedActors_.end()) {
-            return it->second.GetLightShadowState(lightFormId);
+            // Slot order depends on reuse, keep the form ID order callers got from the old map
+            std::sort(actorIds.begin(), actorIds.end());
+            return actorIds;
         }
 
-        return std::nullopt;
+        // Sort on cached keys only, actors that could not be resolved go last
+        auto keys = GatherDistanceKeys([](const TrackedActor&) { return true; });
+        std::sort(keys.begin(), keys.end(), [closestFirst](const DistanceKey& a, const DistanceKey& b) {
+            if (a.valid != b.valid) return a.valid;
+            if (a.distanceSq != b.distanceSq) {
+                return closestFirst ? (a.distanceSq < b.distanceSq) : (a.distanceSq > b.distanceSq);
+            }
+            return a.actorFormId < b.actorFormId;
+        });
+
+        actorIds.reserve(keys.size());
+        for (const auto& key : keys) {
+            actorIds.push_back(key.actorFormId);
+        }
+        return actorIds;
     }
 
-    bool ActorTracker::ActorHasAnyLightWithShadows(uint32_t actorFormId) const {
-        std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint32_t> ActorTracker::GetActorIdsInRange(float maxDistance) {
+        RefreshPendingSlots();
+
+        std::vector<uint32_t> actorIds;
+        grid_.ForEachInRange(cachedPlayerPos_, maxDistance, [&](uint32_t index, float) {
+            if (IsCachedLive(index)) {
+                actorIds.push_back(slotFormIds_[index].load(std::memory_order_acquire));
+            }
+        });
+        std::sort(actorIds.begin(), actorIds.end());
+        return actorIds;
+    }
 
-        auto it = trackedActors_.find(actorFormId);
-        if (it != trackedActors_.end()) {
-            return it->second.HasAnyLightWithShadows();
+    std::vector<uint32_t> ActorTracker::GetNearestActorIds(size_t count, float maxDistance) {
+        RefreshPendingSlots();
+
+        grid_.FindNearest(cachedPlayerPos_, count, maxDistance, [this](uint32_t index) { return IsCachedLive(index); },
+                          nearestScratch_);
+
+        std::vector<uint32_t> actorIds;
+        actorIds.reserve(nearestScratch_.size());
+        for (const auto& [distanceSq, index] : nearestScratch_) {
+            actorIds.push_back(slotFormIds_[index].load(std::memory_order_acquire));
         }
+        return actorIds;
+    }
 
-        return false;
+    // Lower goes first when enabling shadows and last when disabling them, so hand-held lights get the budget
+    static int LightPriority(ConfigType type) {
+        switch (type) {
+            case ConfigType::HandheldLight:
+                return 0;
+            case ConfigType::SpellLight:
+                return 1;
+            case ConfigType::EnchantmentLight:
+                return 2;
+            default:
+                return 3;
+        }
     }
 
-    bool ActorTracker::ContainsTrackedNpcs() const {
-        std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ShadowCandidate> ActorTracker::SelectShadowCandidates(
+        size_t count, bool closestFirst, bool targetShadowState, float maxDistance,
+        std::chrono::steady_clock::time_point changedBefore) {
+        std::vector<ShadowCandidate> candidates;
+        if (count == 0) {
+            return candidates;
+        }
 
-        for (const auto& [actorFormId, actor] : trackedActors_) {
-            if (actorFormId != 0x14) {
-                return true;
+        // Live light state, the cached flags may predate state changes made earlier this tick
+        auto needsChange = [targetShadowState](const TrackedLight& light) {
+            return light.hasShadows != targetShadowState;
+        };
+        auto eligible = [&](uint32_t index) {
+            if (!IsCachedLive(index)) return false;
+            if (slots_[index].actor.GetLastTransitionTime() > changedBefore) return false;
+            auto lights = slots_[index].actor.GetTrackedLights();
+            return std::any_of(lights.begin(), lights.end(), needsChange);
+        };
+
+        // Budget is spent per light, so every light needing the change is its own candidate
+        struct LightKey {
+            ShadowCandidate candidate;
+            float distanceSq;
+            int priority;
+        };
+        std::vector<LightKey> lightKeys;
+        auto addLights = [&](uint32_t index, float distanceSq) {
+            uint32_t actorFormId = slotFormIds_[index].load(std::memory_order_acquire);
+            for (const auto& light : slots_[index].actor.GetTrackedLights()) {
+                if (needsChange(light)) {
+                    lightKeys.push_back({{actorFormId, light.formId}, distanceSq, LightPriority(light.type)});
+                }
+            }
+        };
+
+        RefreshPendingSlots();
+        if (closestFirst) {
+            // Every actor contributes at least one light, so the nearest `count` actors cover the nearest lights
+            grid_.FindNearest(cachedPlayerPos_, count, maxDistance, eligible, nearestScratch_);
+            for (const auto& [distanceSq, index] : nearestScratch_) {
+                addLights(index, distanceSq);
             }
+        } else {
+            grid_.ForEachInRange(cachedPlayerPos_, maxDistance, [&](uint32_t index, float distanceSq) {
+                if (eligible(index)) addLights(index, distanceSq);
+            });
         }
 
-        return false;
+        auto before = [closestFirst](const LightKey& a, const LightKey& b) {
+            if (a.distanceSq != b.distanceSq) {
+                return closestFirst ? (a.distanceSq < b.distanceSq) : (a.distanceSq > b.distanceSq);
+            }
+            if (a.priority != b.priority) {
+                return closestFirst ? (a.priority < b.priority) : (a.priority > b.priority);
+            }
+            if (a.candidate.actorFormId != b.candidate.actorFormId) {
+                return a.candidate.actorFormId < b.candidate.actorFormId;
+            }
+            return a.candidate.lightFormId < b.candidate.lightFormId;
+        };
+
+        // Only the first `count` need ordering, partition them out before sorting
+        if (lightKeys.size() > count) {
+            std::nth_element(lightKeys.begin(), lightKeys.begin() + count, lightKeys.end(), before);
+            lightKeys.resize(count);
+        }
+        std::sort(lightKeys.begin(), lightKeys.end(), before);
+
+        candidates.reserve(lightKeys.size());
+        for (const auto& key : lightKeys) {
+            candidates.push_back(key.candidate);
+        }
+        return candidates;
     }
+
+    size_t ActorTracker::GetTrackedActorCount() const {
+        return aggregates_.trackedActors.load(std::memory_order_relaxed);
+    }
+
+    size_t ActorTracker::GetTrackedActorsWithShadowsCount() const {
+        return aggregates_.shadowedActors.load(std::memory_order_relaxed);
+    }
+
+    size_t ActorTracker::GetReEquippingActorCount() const {
+        return aggregates_.reEquippingActors.load(std::memory_order_relaxed);
+    }
+
+    size_t ActorTracker::GetShadowedLightCount() const {
+        return aggregates_.shadowedLights.load(std::memory_order_relaxed);
+    }
+
+    size_t ActorTracker::GetTrackedLightCountByType(ConfigType type) const {
+        return aggregates_.lightsByType[static_cast<size_t>(type)].load(std::memory_order_relaxed);
+    }
+
+    uint32_t ActorTracker::GetStateEpoch() const { return aggregates_.epoch.load(std::memory_order_relaxed); }
+
+    void ActorTracker::SetActorLightShadowState(uint32_t actorFormId, uint32_t lightFormId, bool hasShadows) {
+        auto* actor = GetOrCreateActor(actorFormId);
+        if (actor) {
+            actor->SetLightShadowState(lightFormId, hasShadows);
+        }
+    }
+
+    std::optional<bool> ActorTracker::GetActorLightShadowState(uint32_t actorFormId, uint32_t lightFormId) const {
+        if (const auto* actor = ResolveConst(FindHandle(actorFormId))) {
+            return actor->GetLightShadowState(lightFormId);
+        }
+        return std::nullopt;
+    }
+
+    bool ActorTracker::ActorHasAnyLightWithShadows(uint32_t actorFormId) const {
+        const auto* actor = ResolveConst(FindHandle(actorFormId));
+        return actor && actor->HasAnyLightWithShadows();
+    }
+
+    bool ActorTracker::ContainsTrackedNpcs() const { return aggregates_.npcActors.load(std::memory_order_relaxed) > 0; }
 }
@@ -1,31 +1,92 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <mutex>
 #include <optional>
+#include <thread>
 #include <vector>
 
+#include "ActorGrid.h"
 #include "TrackedActor.h"
 
 namespace ActorShadowLimiter {
 
+    /**
+     * Stable reference to a tracked actor slot. Resolves to null once the actor is removed, even if
+     * the slot has since been reused, so it is safe to hold across delays and threads.
+     */
+    struct ActorHandle {
+        uint32_t index = 0;
+        uint32_t generation = 0;  // Odd while the slot is live, 0 never names an actor
+
+        explicit operator bool() const { return generation != 0; }
+    };
+
+    struct ShadowCandidate {
+        uint32_t actorFormId = 0;
+        uint32_t lightFormId = 0;
+    };
+
+    /**
+     * Tracked actors in fixed slots. Form ID lookups (FindHandle, HasActor), handles and the counts are
+     * lock-free and safe from any thread. TrackedActor objects themselves are not synchronized, so
+     * resolving, adding and removing actors is main thread only; once bound with BindToMainThread(),
+     * these calls made on any other thread are refused and logged. A freed slot is reused in place for
+     * the next actor, so a TrackedActor pointer is only good until the next call that can remove an
+     * actor (RemoveActor, RemoveActorLight, ClearAllActors, or a light switch). Resolve again after
+     * those, and hold a handle across delays.
+     */
     class ActorTracker {
     public:
         // Singleton access
         static ActorTracker& GetSingleton();
 
-        // Actor management
+        // Makes the calling thread the only one allowed to touch actors. Call once at plugin load.
+        void BindToMainThread();
+
+        // Handle access, lookups are lock-free
+        ActorHandle GetOrCreateHandle(uint32_t actorFormId);
+        ActorHandle FindHandle(uint32_t actorFormId) const;
+        TrackedActor* Resolve(ActorHandle handle);
+
+        // Actor management, main thread only
         TrackedActor* GetOrCreateActor(uint32_t actorFormId);
         TrackedActor* GetActor(uint32_t actorFormId);
         void AddActor(uint32_t actorFormId);
         bool HasActor(uint32_t actorFormId) const;
         void RemoveActor(uint32_t actorFormId);
+        void RemoveActorLight(uint32_t actorFormId, uint32_t lightFormId);  // Drops the actor with its last light
         void ClearAllActors();
         bool ContainsTrackedNpcs() const;
 
-        // Get all tracked actors
-        std::vector<uint32_t> GetAllTrackedActorIds(bool sortByDistance = false, bool closestFirst = true) const;
+        // Snapshot positions, distances and light state of all tracked actors. Main thread, once per tick.
+        void RefreshCachedPositions();
+
+        // Get all tracked actors. Distance sorting uses the cached keys and must run on the main thread.
+        std::vector<uint32_t> GetAllTrackedActorIds(bool sortByDistance = false, bool closestFirst = true);
+
+        // Spatial queries around the player on the cached grid, main thread only. Cost scales with the result.
+        std::vector<uint32_t> GetActorIdsInRange(float maxDistance);  // Sorted by form ID
+        std::vector<uint32_t> GetNearestActorIds(size_t count, float maxDistance);  // Closest first
+
+        /**
+         * Up to `count` lights of actors within `maxDistance` that are not yet in `targetShadowState`,
+         * nearest or furthest actor first, then by light type priority. Actors whose last transition is
+         * later than `changedBefore` are passed over. Only visits actors the grid query returns, main
+         * thread only.
+         */
+        std::vector<ShadowCandidate> SelectShadowCandidates(
+            size_t count, bool closestFirst, bool targetShadowState, float maxDistance,
+            std::chrono::steady_clock::time_point changedBefore = std::chrono::steady_clock::time_point::max());
+        // Incrementally maintained counts, O(1) and safe from any thread
         size_t GetTrackedActorCount() const;
         size_t GetTrackedActorsWithShadowsCount() const;
+        size_t GetReEquippingActorCount() const;
+        size_t GetShadowedLightCount() const;
+        size_t GetTrackedLightCountByType(ConfigType type) const;
+        uint32_t GetStateEpoch() const;  // Changes whenever actors or their light states do
 
         // Light management shortcuts
         void SetActorLightShadowState(uint32_t actorFormId, uint32_t lightFormId, bool hasShadows);
@@ -39,8 +100,80 @@ namespace ActorShadowLimiter {
     private:
         ActorTracker() = default;
 
-        std::map<uint32_t, TrackedActor> trackedActors_;
-        mutable std::mutex mutex_;
+        // Far above the actors a single cell can load, slots never move so readers need no lock
+        static constexpr uint32_t kMaxTrackedActors = 1024;
+
+        struct Slot {
+            std::atomic<uint32_t> generation{0};  // Bumped on insert and remove, odd while live
+            TrackedActor actor{0};
+        };
+
+        // Per-slot cache laid out as parallel arrays so distance sorts touch only what they compare
+        struct PositionCache {
+            std::array<float, kMaxTrackedActors> posX{};
+            std::array<float, kMaxTrackedActors> posY{};
+            std::array<float, kMaxTrackedActors> posZ{};
+            std::array<float, kMaxTrackedActors> distanceSq{};
+            std::array<uint32_t, kMaxTrackedActors> generation{};  // Slot generation the entry was taken at
+            std::array<uint8_t, kMaxTrackedActors> flags{};
+        };
+
+        enum CacheFlags : uint8_t {
+            kCachedValid = 1 << 0,  // Actor form resolved and has a position
+            kCachedHasLight = 1 << 1,
+            kCachedHasShadows = 1 << 2,
+        };
+
+        struct DistanceKey {
+            uint32_t actorFormId;
+            uint32_t index;
+            float distanceSq;
+            bool valid;
+        };
+
+        // Form ID index: open addressing kept at or below 3/4 load, each entry one atomic so readers take no
+        // lock. A reader that overlaps a rebuild falls back to scanning the slots.
+        static constexpr uint32_t kIndexCapacity = kMaxTrackedActors * 2;
+        static constexpr uint32_t kTombstoneFormId = 0xFFFFFFFF;  // Marks a removed entry, never a real form
+
+        static uint32_t IndexSlot(uint32_t actorFormId);
+        ActorHandle VerifyHandle(uint32_t index, uint32_t actorFormId) const;
+        ActorHandle ScanHandle(uint32_t actorFormId) const;
+        void IndexInsert(uint32_t actorFormId, uint32_t index);  // Caller holds writeMutex_
+        void IndexPlace(uint32_t actorFormId, uint32_t index);   // Caller holds writeMutex_
+        void IndexRemove(uint32_t actorFormId);                  // Caller holds writeMutex_
+        void RebuildIndex();                                     // Caller holds writeMutex_
+
+        bool IsActorAccessAllowed() const;  // False off the bound main thread, reported once
+        const TrackedActor* ResolveConst(ActorHandle handle) const;
+        void RemoveSlot(uint32_t index);  // Caller holds writeMutex_
+        void RefreshCachedSlot(uint32_t index, uint32_t generation, const RE::NiPoint3& playerPos);
+        void RefreshPendingSlots();  // Caches slots created since the last refresh
+        bool IsCachedLive(uint32_t index) const;
+        template <class Filter>
+        std::vector<DistanceKey> GatherDistanceKeys(Filter&& filter);  // Live slots passing `filter`
+
+        // Form IDs are kept apart from the slots so the fallback scan touches one dense array
+        std::array<std::atomic<uint32_t>, kMaxTrackedActors> slotFormIds_{};
+        std::array<std::atomic<uint64_t>, kIndexCapacity> index_{};  // Form ID << 32 | slot index, 0 if empty
+        std::atomic<uint32_t> indexVersion_{0};                       // Odd while the index is rebuilt
+        uint32_t indexUsed_ = 0;  // Live entries plus tombstones, guarded by writeMutex_
+        bool fullReported_ = false;  // Guarded by writeMutex_
+        std::thread::id mainThread_;  // Set once at plugin load, before any other thread runs
+        mutable std::atomic<bool> wrongThreadReported_{false};
+        std::array<Slot, kMaxTrackedActors> slots_;
+        std::atomic<uint32_t> slotCount_{0};  // Slots ever used, readers scan up to here
+        std::vector<uint32_t> freeSlots_;
+        std::mutex writeMutex_;
+        std::vector<uint32_t> pendingSlots_;  // Created since the last refresh, guarded by writeMutex_
+        TrackerAggregates aggregates_;
+
+        // Main thread only
+        PositionCache positionCache_;
+        ActorGrid grid_;  // Valid cached slots by position, rebuilt with the cache
+        RE::NiPoint3 cachedPlayerPos_;
+        std::vector<uint32_t> pendingScratch_;
+        std::vector<std::pair<float, uint32_t>> nearestScratch_;
     };
 
 }
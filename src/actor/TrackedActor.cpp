@@ -2,44 +2,184 @@
 
 namespace ActorShadowLimiter {
 
-    TrackedActor::TrackedActor(uint32_t actorFormId) : actorFormId_(actorFormId) {}
+    TrackedActor::TrackedActor(uint32_t actorFormId, TrackerAggregates* aggregates)
+        : actorFormId_(actorFormId), aggregates_(aggregates) {}
 
     uint32_t TrackedActor::GetActorFormId() const { return actorFormId_; }
 
-    void TrackedActor::SetTrackedLight(uint32_t lightFormId) { trackedLightFormId_ = lightFormId; }
+    TrackedActor::Contribution TrackedActor::GetContribution() const {
+        Contribution contribution;
+        for (const auto& light : GetTrackedLights()) {
+            contribution.shadowedLights += light.hasShadows;
+            contribution.reEquippingLights += light.isReEquipping;
+            ++contribution.lightsByType[static_cast<size_t>(light.type)];
+        }
+        return contribution;
+    }
+
+    void TrackedActor::ApplyContribution(const Contribution& contribution, bool add) {
+        if (!aggregates_) return;
+
+        auto apply = [add](std::atomic<uint32_t>& counter, uint32_t amount) {
+            if (amount == 0) return;
+            if (add) {
+                counter.fetch_add(amount, std::memory_order_relaxed);
+            } else {
+                counter.fetch_sub(amount, std::memory_order_relaxed);
+            }
+        };
+        apply(aggregates_->shadowedActors, contribution.shadowedLights > 0);
+        apply(aggregates_->shadowedLights, contribution.shadowedLights);
+        apply(aggregates_->reEquippingActors, contribution.reEquippingLights > 0);
+        for (size_t i = 0; i < contribution.lightsByType.size(); ++i) {
+            apply(aggregates_->lightsByType[i], contribution.lightsByType[i]);
+        }
+        aggregates_->epoch.fetch_add(1, std::memory_order_relaxed);
+    }
 
-    void TrackedActor::SetLightShadowState(uint32_t lightFormId, bool hasShadows) {
-        trackedLightFormId_ = lightFormId;
-        hasShadows_ = hasShadows;
+    void TrackedActor::UpdateAggregates(const Contribution& before) {
+        auto after = GetContribution();
+        if (before.shadowedLights == after.shadowedLights && before.reEquippingLights == after.reEquippingLights &&
+            before.lightsByType == after.lightsByType) {
+            return;
+        }
+        ApplyContribution(before, false);
+        ApplyContribution(after, true);
+    }
+
+    void TrackedActor::AttachAggregates(TrackerAggregates* aggregates) {
+        DetachAggregates();
+        aggregates_ = aggregates;
+        if (!aggregates_) return;
+
+        aggregates_->trackedActors.fetch_add(1, std::memory_order_relaxed);
+        if (actorFormId_ != 0x14) {
+            aggregates_->npcActors.fetch_add(1, std::memory_order_relaxed);
+        }
+        ApplyContribution(GetContribution(), true);
+    }
+
+    void TrackedActor::DetachAggregates() {
+        if (!aggregates_) return;
+
+        ApplyContribution(GetContribution(), false);
+        if (actorFormId_ != 0x14) {
+            aggregates_->npcActors.fetch_sub(1, std::memory_order_relaxed);
+        }
+        aggregates_->trackedActors.fetch_sub(1, std::memory_order_relaxed);
+        aggregates_ = nullptr;
+    }
+
+    TrackedLight* TrackedActor::FindLight(uint32_t lightFormId) {
+        return const_cast<TrackedLight*>(static_cast<const TrackedActor*>(this)->FindLight(lightFormId));
+    }
+
+    const TrackedLight* TrackedActor::FindLight(uint32_t lightFormId) const {
+        for (const auto& light : GetTrackedLights()) {
+            if (light.formId == lightFormId) {
+                return &light;
+            }
+        }
+        return nullptr;
+    }
+
+    TrackedLight* TrackedActor::FindOrAddLight(uint32_t lightFormId) {
+        if (auto* light = FindLight(lightFormId)) {
+            return light;
+        }
+        if (lightCount_ >= kMaxTrackedLights) {
+            return nullptr;
+        }
+
+        auto& light = lights_[lightCount_++];
+        light = {lightFormId, GetConfigRegistry().Find(lightFormId).type};
+        return &light;
+    }
+
+    bool TrackedActor::TrackLight(uint32_t lightFormId) {
+        auto before = GetContribution();
+        bool tracked = FindOrAddLight(lightFormId) != nullptr;
+        UpdateAggregates(before);
+        return tracked;
+    }
+
+    bool TrackedActor::SetLightShadowState(uint32_t lightFormId, bool hasShadows) {
+        auto before = GetContribution();
+        auto* light = FindOrAddLight(lightFormId);
+        if (light) {
+            light->hasShadows = hasShadows;
+        }
+        UpdateAggregates(before);
+        return light != nullptr;
     }
 
     bool TrackedActor::GetLightShadowState(uint32_t lightFormId) const {
-        if (trackedLightFormId_.has_value() && trackedLightFormId_.value() == lightFormId) {
-            return hasShadows_;
+        const auto* light = FindLight(lightFormId);
+        return light && light->hasShadows;
+    }
+
+    bool TrackedActor::HasAnyLightWithShadows() const {
+        for (const auto& light : GetTrackedLights()) {
+            if (light.hasShadows) {
+                return true;
+            }
         }
         return false;
     }
 
-    bool TrackedActor::HasAnyLightWithShadows() const { return trackedLightFormId_.has_value() && hasShadows_; }
-
     void TrackedActor::RemoveLight(uint32_t lightFormId) {
-        if (trackedLightFormId_.has_value() && trackedLightFormId_.value() == lightFormId) {
-            trackedLightFormId_.reset();
-            hasShadows_ = false;
+        auto* light = FindLight(lightFormId);
+        if (!light) return;
+
+        // Order does not matter, fill the gap with the last light
+        auto before = GetContribution();
+        *light = lights_[--lightCount_];
+        lights_[lightCount_] = {};
+        UpdateAggregates(before);
+    }
+
+    void TrackedActor::ClearTrackedLights() {
+        auto before = GetContribution();
+        lights_ = {};
+        lightCount_ = 0;
+        UpdateAggregates(before);
+    }
+
+    std::span<const TrackedLight> TrackedActor::GetTrackedLights() const { return {lights_.data(), lightCount_}; }
+
+    bool TrackedActor::HasTrackedLight() const { return lightCount_ > 0; }
+
+    bool TrackedActor::IsTrackingLight(uint32_t lightFormId) const { return FindLight(lightFormId) != nullptr; }
+
+    bool TrackedActor::CanTrackLight(uint32_t lightFormId) const {
+        return lightCount_ < kMaxTrackedLights || IsTrackingLight(lightFormId);
+    }
+
+    bool TrackedActor::IsReEquipping() const {
+        for (const auto& light : GetTrackedLights()) {
+            if (light.isReEquipping) {
+                return true;
+            }
         }
+        return false;
     }
 
-    void TrackedActor::ClearTrackedLight() {
-        trackedLightFormId_.reset();
-        hasShadows_ = false;
+    bool TrackedActor::IsReEquipping(uint32_t lightFormId) const {
+        const auto* light = FindLight(lightFormId);
+        return light && light->isReEquipping;
     }
 
-    std::optional<uint32_t> TrackedActor::GetTrackedLight() const { return trackedLightFormId_; }
+    void TrackedActor::SetReEquipping(uint32_t lightFormId, bool reEquipping) {
+        auto* light = FindLight(lightFormId);
+        if (!light) return;
 
-    bool TrackedActor::HasTrackedLight() const { return trackedLightFormId_.has_value(); }
+        auto before = GetContribution();
+        light->isReEquipping = reEquipping;
+        UpdateAggregates(before);
+    }
 
-    bool TrackedActor::IsReEquipping() const { return isReEquipping_; }
+    std::chrono::steady_clock::time_point TrackedActor::GetLastTransitionTime() const { return lastTransition_; }
 
-    void TrackedActor::SetReEquipping(bool reEquipping) { isReEquipping_ = reEquipping; }
+    void TrackedActor::MarkTransition(std::chrono::steady_clock::time_point time) { lastTransition_ = time; }
 
 }
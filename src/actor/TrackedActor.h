@@ -1,38 +1,96 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
-#include <optional>
+#include <span>
+
+#include "../core/ConfigRegistry.h"
 
 namespace ActorShadowLimiter {
 
+    /**
+     * Counts over all tracked actors, kept current by every state change so queries are a single
+     * atomic load and never walk the tracker.
+     */
+    struct TrackerAggregates {
+        std::atomic<uint32_t> trackedActors{0};
+        std::atomic<uint32_t> npcActors{0};
+        std::atomic<uint32_t> shadowedActors{0};     // Actors with at least one shadowed light
+        std::atomic<uint32_t> shadowedLights{0};
+        std::atomic<uint32_t> reEquippingActors{0};  // Actors with at least one light mid re-equip
+        std::array<std::atomic<uint32_t>, 4> lightsByType{};  // Tracked lights, indexed by ConfigType
+        std::atomic<uint32_t> epoch{0};  // Bumped on every change to the counts above
+    };
+
+    /**
+     * One configured light, spell or armor an actor is carrying, with its own shadow state.
+     */
+    struct TrackedLight {
+        uint32_t formId = 0;
+        ConfigType type = ConfigType::None;
+        bool hasShadows = false;
+        bool isReEquipping = false;
+    };
+
     class TrackedActor {
     public:
+        // Torch, light spell and enchanted lantern at once, with room to spare
+        static constexpr size_t kMaxTrackedLights = 4;
+
         // Constructor
-        explicit TrackedActor(uint32_t actorFormId);
+        explicit TrackedActor(uint32_t actorFormId, TrackerAggregates* aggregates = nullptr);
 
         // Actor ID
         uint32_t GetActorFormId() const;
 
-        // Light tracking
-        void SetTrackedLight(uint32_t lightFormId);
-        void SetLightShadowState(uint32_t lightFormId, bool hasShadows);
+        // Light tracking. TrackLight and SetLightShadowState return false when all light slots are taken.
+        bool TrackLight(uint32_t lightFormId);
+        bool SetLightShadowState(uint32_t lightFormId, bool hasShadows);
         bool GetLightShadowState(uint32_t lightFormId) const;
         bool HasAnyLightWithShadows() const;
         void RemoveLight(uint32_t lightFormId);
-        void ClearTrackedLight();
+        void ClearTrackedLights();
 
-        std::optional<uint32_t> GetTrackedLight() const;
+        std::span<const TrackedLight> GetTrackedLights() const;
         bool HasTrackedLight() const;
+        bool IsTrackingLight(uint32_t lightFormId) const;
+        bool CanTrackLight(uint32_t lightFormId) const;
 
-        // Re-equipping state
+        // Re-equipping state, per light so sequences on different lights do not clear each other
         bool IsReEquipping() const;
-        void SetReEquipping(bool reEquipping);
+        bool IsReEquipping(uint32_t lightFormId) const;
+        void SetReEquipping(uint32_t lightFormId, bool reEquipping);
+
+        // Last time the shadow policy switched one of this actor's lights, for its minimum dwell time
+        std::chrono::steady_clock::time_point GetLastTransitionTime() const;
+        void MarkTransition(std::chrono::steady_clock::time_point time);
+
+        // Adds or removes this actor's whole contribution, used when the tracker inserts or drops it
+        void AttachAggregates(TrackerAggregates* aggregates);
+        void DetachAggregates();
 
     private:
+        struct Contribution {
+            uint32_t shadowedLights = 0;
+            uint32_t reEquippingLights = 0;
+            std::array<uint32_t, 4> lightsByType{};
+        };
+
+        TrackedLight* FindLight(uint32_t lightFormId);
+        const TrackedLight* FindLight(uint32_t lightFormId) const;
+        TrackedLight* FindOrAddLight(uint32_t lightFormId);
+
+        Contribution GetContribution() const;
+        void ApplyContribution(const Contribution& contribution, bool add);
+        void UpdateAggregates(const Contribution& before);
+
         uint32_t actorFormId_;
-        std::optional<uint32_t> trackedLightFormId_;
-        bool hasShadows_ = false;
-        bool isReEquipping_ = false;
+        std::array<TrackedLight, kMaxTrackedLights> lights_{};
+        uint8_t lightCount_ = 0;
+        std::chrono::steady_clock::time_point lastTransition_{};
+        TrackerAggregates* aggregates_ = nullptr;
     };
 
 }
@@ -0,0 +1,91 @@
+#include "TrackerSerialization.h"
+
+#include "../core/Globals.h"
+#include "../utils/Console.h"
+#include "ActorTracker.h"
+#include "SKSE/SKSE.h"
+
+namespace ActorShadowLimiter {
+
+    static std::vector<SavedActor> CollectTrackedActors() {
+        auto& tracker = ActorTracker::GetSingleton();
+
+        std::vector<SavedActor> actors;
+        for (uint32_t actorFormId : tracker.GetAllTrackedActorIds()) {
+            auto* trackedActor = tracker.GetActor(actorFormId);
+            if (!trackedActor || !trackedActor->HasTrackedLight()) {
+                continue;
+            }
+
+            SavedActor& actor = actors.emplace_back();
+            actor.actorFormId = actorFormId;
+            for (const auto& light : trackedActor->GetTrackedLights()) {
+                actor.lights.push_back({light.formId, light.hasShadows});
+            }
+        }
+        return actors;
+    }
+
+    static void OnGameSaved(SKSE::SerializationInterface* serialization) {
+        auto actors = CollectTrackedActors();
+        if (!serialization->OpenRecord(kTrackerRecordType, kTrackerRecordVersion) ||
+            !WriteTrackedActors(*serialization, actors)) {
+            DebugPrint("SAVE", "Warning: Failed to write tracker record");
+            return;
+        }
+        DebugPrint("SAVE", "Saved %zu tracked actors", actors.size());
+    }
+
+    static void OnGameLoaded(SKSE::SerializationInterface* serialization) {
+        auto& tracker = ActorTracker::GetSingleton();
+        tracker.ClearAllActors();
+        g_restoredActorsPending = false;
+
+        std::uint32_t type = 0;
+        std::uint32_t version = 0;
+        std::uint32_t length = 0;
+        while (serialization->GetNextRecordInfo(type, version, length)) {
+            if (type != kTrackerRecordType) {
+                continue;
+            }
+
+            std::vector<SavedActor> actors;
+            auto resolve = [serialization](std::uint32_t oldFormId, std::uint32_t& newFormId) {
+                return serialization->ResolveFormID(oldFormId, newFormId);
+            };
+            if (!ReadTrackedActors(*serialization, version, actors, resolve)) {
+                DebugPrint("LOAD", "Warning: Tracker record version %u is unreadable, skipping", version);
+                continue;
+            }
+
+            // Restored states are what the saved light references carry, the first update reconciles them
+            for (const auto& actor : actors) {
+                auto* trackedActor = tracker.GetOrCreateActor(actor.actorFormId);
+                if (!trackedActor) {
+                    break;
+                }
+                for (const auto& light : actor.lights) {
+                    trackedActor->SetLightShadowState(light.formId, light.hasShadows);
+                }
+            }
+            g_restoredActorsPending = tracker.GetTrackedActorCount() > 0;
+            DebugPrint("LOAD", "Restored %zu tracked actors", actors.size());
+        }
+    }
+
+    static void OnRevert(SKSE::SerializationInterface*) {
+        g_restoredActorsPending = false;
+        ActorTracker::GetSingleton().ClearAllActors();
+    }
+
+    void InstallTrackerSerialization() {
+        auto* serialization = SKSE::GetSerializationInterface();
+        if (!serialization) {
+            return;
+        }
+        serialization->SetUniqueID(kSerializationUniqueId);
+        serialization->SetSaveCallback(OnGameSaved);
+        serialization->SetLoadCallback(OnGameLoaded);
+        serialization->SetRevertCallback(OnRevert);
+    }
+}
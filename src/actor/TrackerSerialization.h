@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace ActorShadowLimiter {
+
+    // Co-save layout: actor count, then per actor its form ID, light count and lights. All fields uint32.
+    inline constexpr std::uint32_t kSerializationUniqueId = 0x41534844;  // "ASHD"
+    inline constexpr std::uint32_t kTrackerRecordType = 0x5452414B;      // "TRAK"
+    inline constexpr std::uint32_t kTrackerRecordVersion = 1;
+
+    struct SavedLight {
+        std::uint32_t formId = 0;
+        bool hasShadows = false;
+    };
+
+    struct SavedActor {
+        std::uint32_t actorFormId = 0;
+        std::vector<SavedLight> lights;
+    };
+
+    /**
+     * Writes the tracker record body. `Writer` needs `bool WriteRecordData(const void*, std::uint32_t)`,
+     * which SKSE's serialization interface provides and an in-memory buffer can stand in for.
+     */
+    template <class Writer>
+    bool WriteTrackedActors(Writer& out, std::span<const SavedActor> actors) {
+        auto write = [&out](std::uint32_t value) { return out.WriteRecordData(&value, sizeof(value)); };
+
+        if (!write(static_cast<std::uint32_t>(actors.size()))) return false;
+        for (const auto& actor : actors) {
+            if (!write(actor.actorFormId) || !write(static_cast<std::uint32_t>(actor.lights.size()))) return false;
+            for (const auto& light : actor.lights) {
+                if (!write(light.formId) || !write(light.hasShadows ? 1u : 0u)) return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Reads a tracker record body written by WriteTrackedActors. `Reader` needs
+     * `std::uint32_t ReadRecordData(void*, std::uint32_t)`, `resolve(oldFormId, newFormId&)` maps
+     * saved form IDs to the current load order. Actors and lights that no longer resolve are dropped.
+     */
+    template <class Reader, class Resolve>
+    bool ReadTrackedActors(Reader& in, std::uint32_t version, std::vector<SavedActor>& actors, Resolve&& resolve) {
+        if (version != kTrackerRecordVersion) {
+            return false;
+        }
+
+        auto read = [&in](std::uint32_t& value) { return in.ReadRecordData(&value, sizeof(value)) == sizeof(value); };
+
+        // Counts come from disk, read element by element so a corrupt count fails on the first short read
+        std::uint32_t actorCount = 0;
+        if (!read(actorCount)) return false;
+        for (std::uint32_t i = 0; i < actorCount; ++i) {
+            SavedActor actor;
+            std::uint32_t lightCount = 0;
+            if (!read(actor.actorFormId) || !read(lightCount)) return false;
+
+            for (std::uint32_t j = 0; j < lightCount; ++j) {
+                SavedLight light;
+                std::uint32_t flags = 0;
+                if (!read(light.formId) || !read(flags)) return false;
+
+                light.hasShadows = (flags & 1) != 0;
+                if (resolve(light.formId, light.formId)) {
+                    actor.lights.push_back(light);
+                }
+            }
+
+            if (resolve(actor.actorFormId, actor.actorFormId) && !actor.lights.empty()) {
+                actors.push_back(std::move(actor));
+            }
+        }
+        return true;
+    }
+
+    /**
+     * Registers the save, load and revert callbacks that persist the actor tracker in the co-save.
+     * Must be called from plugin load.
+     */
+    void InstallTrackerSerialization();
+}
@@ -1,108 +1,102 @@
 #include "Config.h"
 
+#include <algorithm>
+#include <atomic>
 #include <filesystem>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 #include "../utils/Console.h"
+#include "../utils/Hash.h"
+#include "ConfigCache.h"
+#include "ConfigRegistry.h"
+#include "FormResolver.h"
+#include "JsonParser.h"
 
 namespace ActorShadowLimiter {
 
-    Config g_config;
-
     bool IsInConfig(RE::TESObjectLIGH* lightBase) {
-        for (const auto& config : g_config.handHeldLights) {
-            if (config.formId == lightBase->GetFormID()) {
-                return true;
-            }
-        }
-        return false;
+        return GetConfigRegistry().Find(lightBase->GetFormID()).type == ConfigType::HandheldLight;
     }
 
     bool IsInConfig(RE::TESForm* form) {
-        if (form->GetFormType() == RE::FormType::Light) {
-            auto* lightBase = form->As<RE::TESObjectLIGH>();
-            return IsInConfig(lightBase);
-        } else if (form->GetFormType() == RE::FormType::Spell) {
-            auto* spell = form->As<RE::SpellItem>();
-            return IsInConfig(spell);
-        } else if (form->GetFormType() == RE::FormType::Armor) {
-            auto* armor = form->As<RE::TESObjectARMO>();
-            return IsInConfig(armor);
-        }
-        return false;
+        auto lookup = GetConfigRegistry().Find(form->GetFormID());
+        switch (form->GetFormType()) {
+            case RE::FormType::Light:
+                return lookup.type == ConfigType::HandheldLight;
+            case RE::FormType::Spell:
+                return lookup.type == ConfigType::SpellLight;
+            case RE::FormType::Armor:
+                return lookup.type == ConfigType::EnchantmentLight;
+            default:
+                return false;
+        }
     }
 
     bool IsInConfig(RE::SpellItem* spell) {
-        for (const auto& config : g_config.spells) {
-            if (config.formId == spell->GetFormID()) {
-                return true;
-            }
-        }
-        return false;
+        return GetConfigRegistry().Find(spell->GetFormID()).type == ConfigType::SpellLight;
     }
 
     bool IsInConfig(RE::TESObjectARMO* armor) {
-        for (const auto& config : g_config.enchantedArmors) {
-            if (config.formId == armor->GetFormID()) {
-                return true;
-            }
-        }
-        return false;
+        return GetConfigRegistry().Find(armor->GetFormID()).type == ConfigType::EnchantmentLight;
     }
 
     static std::string ReadFileText(const std::string& path) {
-        std::ifstream f(path);
+        std::ifstream f(path, std::ios::binary | std::ios::ate);
         if (!f.is_open()) return "";
-        std::ostringstream ss;
-        ss << f.rdbuf();
-        return ss.str();
+        std::string text(static_cast<size_t>(f.tellg()), '\0');
+        f.seekg(0);
+        f.read(text.data(), static_cast<std::streamsize>(text.size()));
+        return text;
     }
 
-    static std::string ExtractValue(const std::string& json, const std::string& key, size_t startPos) {
-        std::string searchKey = "\"" + key + "\"";
-        size_t keyPos = json.find(searchKey, startPos);
-        if (keyPos == std::string::npos) return "";
-
-        size_t colonPos = json.find(':', keyPos);
-        if (colonPos == std::string::npos) return "";
-
-        size_t valueStart = json.find_first_not_of(" \t\n\r", colonPos + 1);
-        if (valueStart == std::string::npos) return "";
-
-        if (json[valueStart] == '"') {
-            size_t valueEnd = json.find('"', valueStart + 1);
-            if (valueEnd == std::string::npos) return "";
-            return json.substr(valueStart + 1, valueEnd - valueStart - 1);
-        } else {
-            size_t valueEnd = json.find_first_of(",}\n", valueStart);
-            if (valueEnd == std::string::npos) valueEnd = json.length();
-            std::string value = json.substr(valueStart, valueEnd - valueStart);
-            size_t lastNonSpace = value.find_last_not_of(" \t\n\r");
-            if (lastNonSpace != std::string::npos) {
-                value = value.substr(0, lastNonSpace + 1);
-            }
-            return value;
-        }
+    template <class T>
+    static T ToLightConfig(const ParsedLightEntry& entry) {
+        T config;
+        config.formId = entry.formId;
+        config.plugin = entry.plugin;
+        config.rootNodeName = entry.rootNodeName;
+        config.lightNodeName = entry.lightNodeName;
+        config.offsetX = entry.offsetX;
+        config.offsetY = entry.offsetY;
+        config.offsetZ = entry.offsetZ;
+        config.rotateX = entry.rotateX;
+        config.rotateY = entry.rotateY;
+        config.rotateZ = entry.rotateZ;
+        return config;
+    }
+
+    template <class T>
+    static RuleConfig<T> ToRuleConfig(const ParsedLightEntry& entry) {
+        RuleConfig<T> rule;
+        rule.match.plugin = entry.plugin;
+        rule.match.keyword = entry.keyword;
+        rule.match.minRadius = entry.minRadius;
+        rule.config = ToLightConfig<T>(entry);
+        rule.config.formId = 0;
+        return rule;
     }
 
     bool IsValidCell(RE::TESObjectCELL* cell) {
+        const auto& config = GetConfig();
         if (!cell) {
             return false;
         }
 
         bool isExterior = cell->IsExteriorCell();
 
-        if (isExterior && !g_config.enableExterior) {
+        if (isExterior && !config.enableExterior) {
             return false;
         }
-        if (!isExterior && !g_config.enableInterior) {
+        if (!isExterior && !config.enableInterior) {
             return false;
         }
         return true;
     }
 
     bool IsValidActor(RE::Actor* actor) {
+        const auto& config = GetConfig();
         if (!actor) {
             return false;
         }
@@ -115,7 +109,7 @@ namespace ActorShadowLimiter {
         }
 
         bool isNpc = actor->IsPlayerRef() == false;
-        if (isNpc && !g_config.enableNpc) {
+        if (isNpc && !config.enableNpc) {
             return false;
         }
 
@@ -131,10 +125,10 @@ namespace ActorShadowLimiter {
             return false;
         }
         bool isExterior = cell->IsExteriorCell();
-        if (isNpc && isExterior && !g_config.enableNpcExterior) {
+        if (isNpc && isExterior && !config.enableNpcExterior) {
             return false;
         }
-        if (isNpc && !isExterior && !g_config.enableNpcInterior) {
+        if (isNpc && !isExterior && !config.enableNpcInterior) {
             return false;
         }
 
@@ -142,203 +136,238 @@ namespace ActorShadowLimiter {
     }
 
     int GetShadowLimit(RE::TESObjectCELL* cell) {
-        return cell->IsExteriorCell() ? g_config.shadowLightLimitExterior : g_config.shadowLightLimit;
+        const auto& config = GetConfig();
+        return cell->IsExteriorCell() ? config.shadowLightLimitExterior : config.shadowLightLimit;
     }
 
     bool IsActorWithinRange(RE::Actor* actor) {
+        const auto& config = GetConfig();
         auto* player = RE::PlayerCharacter::GetSingleton();
         if (!player || !actor) {
             return false;
         }
 
         float distance = player->GetPosition().GetDistance(actor->GetPosition());
-        return distance <= g_config.npcMaxDistance;
+        return distance <= config.npcMaxDistance;
     }
 
-    static void LoadJsonConfig() {
-        std::string configDir = "Data/SKSE/Plugins/ActorShadows";
+    static constexpr int kMinFrameUpdateBudgetMicroseconds = 50;
+    static constexpr int kMaxFrameUpdateBudgetMicroseconds = 4000;
+
+    // Upper bound for config parsing threads, file reads saturate the disk well before this
+    static constexpr size_t kMaxConfigWorkers = 8;
+
+    static constexpr const char* kConfigCachePath = "Data/SKSE/Plugins/ActorShadows.cache";
+
+    struct JsonFileResult {
+        std::filesystem::path path;
+        std::string fileName;
+        ConfigFileFingerprint fingerprint;
+        const CachedConfigFile* cached = nullptr;  // Previous record for this file name, if any
+        bool fromCache = false;
+        std::string text;
+        std::vector<ParsedLightEntry> lights;  // Views into text or the mapped cache
+        std::string error;
+    };
+
+    static bool LoadFromCache(JsonFileResult& result, const ConfigCacheReader& cache) {
+        result.fromCache = cache.ReadFile(*result.cached, result.lights, result.error);
+        if (result.fromCache) {
+            result.fingerprint.contentHash = result.cached->contentHash;
+        }
+        return result.fromCache;
+    }
 
-        // Check if directory exists
-        if (!std::filesystem::exists(configDir)) {
-            DebugPrint("CONFIG", "ActorShadows config directory not found: %s", configDir.c_str());
+    static void LoadJsonFile(JsonFileResult& result, const ConfigCacheReader& cache) {
+        // Unchanged size and timestamp, trust the compiled records without touching the file
+        if (result.cached && result.cached->size == result.fingerprint.size &&
+            result.cached->lastWriteTime == result.fingerprint.lastWriteTime && LoadFromCache(result, cache)) {
             return;
         }
 
-        int fileCount = 0;
+        result.text = ReadFileText(result.path.string());
+        if (result.text.empty()) {
+            result.error = "could not read file";
+            return;
+        }
 
-        // Iterate through all .json files in the directory
-        for (const auto& entry : std::filesystem::directory_iterator(configDir)) {
-            if (!entry.is_regular_file()) continue;
-            if (entry.path().extension() != ".json") continue;
+        // Only the timestamp moved (e.g. a mod manager redeploy), the content hash decides
+        result.fingerprint.contentHash = Fnv1a64(result.text);
+        if (result.cached && result.cached->size == result.fingerprint.size &&
+            result.cached->contentHash == result.fingerprint.contentHash && LoadFromCache(result, cache)) {
+            return;
+        }
 
-            std::string filePath = entry.path().string();
-            std::string json = ReadFileText(filePath);
-            if (json.empty()) {
-                DebugPrint("CONFIG", "Warning: Could not read file %s", filePath.c_str());
-                continue;
+        // A file may hold one entry, an array of entries or a per-plugin pack, all parsed in one pass
+        if (!ParseLightConfig(result.text, result.lights, result.error)) {
+            result.lights.clear();
+            return;
+        }
+        for (size_t i = 0; i < result.lights.size(); ++i) {
+            if (result.lights[i].type.empty()) {
+                result.error = result.lights.size() == 1 ? "missing 'type' field"
+                                                         : "light " + std::to_string(i) + ": missing 'type' field";
+                result.lights.clear();
+                return;
             }
+        }
+    }
 
-            // Extract type field to determine what kind of config this is
-            std::string type = ExtractValue(json, "type", 0);
-            if (type.empty()) {
-                DebugPrint("CONFIG", "Warning: File %s missing 'type' field", filePath.c_str());
-                continue;
+    /**
+     * Loads all files on a small worker pool. Results are written in place, so the vector must
+     * not be resized afterwards as the parsed entries point into each result's text.
+     */
+    static void LoadJsonFilesParallel(std::vector<JsonFileResult>& results, const ConfigCacheReader& cache) {
+        size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+        workerCount = std::min({workerCount, kMaxConfigWorkers, results.size()});
+
+        std::atomic<size_t> nextIndex{0};
+        auto worker = [&results, &cache, &nextIndex]() {
+            for (size_t i = nextIndex++; i < results.size(); i = nextIndex++) {
+                LoadJsonFile(results[i], cache);
             }
+        };
 
-            if (type == "HandheldLight") {
-                HandHeldLightConfig light;
-                std::string formIdStr = ExtractValue(json, "formId", 0);
-                if (!formIdStr.empty()) {
-                    light.formId = std::stoul(formIdStr, nullptr, 0);
-                }
-                light.plugin = ExtractValue(json, "plugin", 0);
-                light.rootNodeName = ExtractValue(json, "rootNodeName", 0);
-                light.lightNodeName = ExtractValue(json, "lightNodeName", 0);
-
-                std::string offsetX = ExtractValue(json, "offsetX", 0);
-                if (!offsetX.empty()) light.offsetX = std::stof(offsetX);
-
-                std::string offsetY = ExtractValue(json, "offsetY", 0);
-                if (!offsetY.empty()) light.offsetY = std::stof(offsetY);
-
-                std::string offsetZ = ExtractValue(json, "offsetZ", 0);
-                if (!offsetZ.empty()) light.offsetZ = std::stof(offsetZ);
-
-                std::string rotateX = ExtractValue(json, "rotateX", 0);
-                if (!rotateX.empty()) light.rotateX = std::stof(rotateX);
-
-                std::string rotateY = ExtractValue(json, "rotateY", 0);
-                if (!rotateY.empty()) light.rotateY = std::stof(rotateY);
-
-                std::string rotateZ = ExtractValue(json, "rotateZ", 0);
-                if (!rotateZ.empty()) light.rotateZ = std::stof(rotateZ);
-
-                g_config.handHeldLights.push_back(light);
-                DebugPrint("CONFIG", "Loaded HandheldLight from %s", entry.path().filename().string().c_str());
-
-            } else if (type == "SpellLight") {
-                SpellConfig spell;
-                std::string formIdStr = ExtractValue(json, "formId", 0);
-                if (!formIdStr.empty()) {
-                    spell.formId = std::stoul(formIdStr, nullptr, 0);
-                }
-                spell.plugin = ExtractValue(json, "plugin", 0);
-                spell.rootNodeName = ExtractValue(json, "rootNodeName", 0);
-                spell.lightNodeName = ExtractValue(json, "lightNodeName", 0);
+        // The calling thread works too, so only spawn the remaining workers
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < workerCount; ++i) {
+            workers.emplace_back(worker);
+        }
+        worker();
+        for (auto& thread : workers) {
+            thread.join();
+        }
+    }
 
-                std::string offsetX = ExtractValue(json, "offsetX", 0);
-                if (!offsetX.empty()) spell.offsetX = std::stof(offsetX);
+    static void LoadJsonConfig(Config& config) {
+        std::string configDir = "Data/SKSE/Plugins/ActorShadows";
 
-                std::string offsetY = ExtractValue(json, "offsetY", 0);
-                if (!offsetY.empty()) spell.offsetY = std::stof(offsetY);
+        // Check if directory exists
+        if (!std::filesystem::exists(configDir)) {
+            DebugPrint("CONFIG", "ActorShadows config directory not found: %s", configDir.c_str());
+            return;
+        }
 
-                std::string offsetZ = ExtractValue(json, "offsetZ", 0);
-                if (!offsetZ.empty()) spell.offsetZ = std::stof(offsetZ);
+        ConfigCacheReader cache;
+        if (!cache.Open(kConfigCachePath)) {
+            DebugPrint("CONFIG", "No valid config cache found, parsing all files");
+        }
 
-                std::string rotateX = ExtractValue(json, "rotateX", 0);
-                if (!rotateX.empty()) spell.rotateX = std::stof(rotateX);
+        // Collect all .json files, sorted by name so duplicates always resolve the same way
+        std::vector<JsonFileResult> results;
+        for (const auto& entry : std::filesystem::directory_iterator(configDir)) {
+            if (!entry.is_regular_file()) continue;
+            if (entry.path().extension() != ".json") continue;
 
-                std::string rotateY = ExtractValue(json, "rotateY", 0);
-                if (!rotateY.empty()) spell.rotateY = std::stof(rotateY);
+            JsonFileResult result;
+            result.path = entry.path();
+            result.fileName = entry.path().filename().string();
+            result.fingerprint.size = entry.file_size();
+            result.fingerprint.lastWriteTime = entry.last_write_time().time_since_epoch().count();
+            results.push_back(std::move(result));
+        }
+        std::sort(results.begin(), results.end(),
+                  [](const auto& a, const auto& b) { return a.fileName < b.fileName; });
 
-                std::string rotateZ = ExtractValue(json, "rotateZ", 0);
-                if (!rotateZ.empty()) spell.rotateZ = std::stof(rotateZ);
+        for (auto& result : results) {
+            result.cached = cache.FindFile(result.fileName);
+        }
+        LoadJsonFilesParallel(results, cache);
 
-                g_config.spells.push_back(spell);
-                DebugPrint("CONFIG", "Loaded SpellLight from %s", entry.path().filename().string().c_str());
+        // Merge on this thread in sorted order
+        int fileCount = 0;
+        size_t cachedCount = 0;
+        size_t staleRecordCount = 0;
+        std::vector<std::string> errors;
+        for (auto& result : results) {
+            if (result.fromCache) {
+                ++cachedCount;
+            }
+            // A record reused by content hash still holds the old timestamp, store the new one
+            if (!result.fromCache || result.cached->size != result.fingerprint.size ||
+                result.cached->lastWriteTime != result.fingerprint.lastWriteTime) {
+                ++staleRecordCount;
+            }
+            if (!result.error.empty()) {
+                errors.push_back(result.fileName + ": " + result.error);
+                continue;
+            }
 
-            } else if (type == "EnchantmentLight") {
-                EnchantedArmorConfig armor;
-                std::string formIdStr = ExtractValue(json, "formId", 0);
-                if (!formIdStr.empty()) {
-                    armor.formId = std::stoul(formIdStr, nullptr, 0);
+            bool anyLoaded = false;
+            for (const auto& light : result.lights) {
+                if (light.isRule) {
+                    if (light.type == "HandheldLight") {
+                        config.handHeldLightRules.push_back(ToRuleConfig<HandHeldLightConfig>(light));
+                    } else if (light.type == "SpellLight") {
+                        config.spellRules.push_back(ToRuleConfig<SpellConfig>(light));
+                    } else if (light.type == "EnchantmentLight") {
+                        config.enchantedArmorRules.push_back(ToRuleConfig<EnchantedArmorConfig>(light));
+                    } else {
+                        errors.push_back(result.fileName + ": unknown type '" + std::string(light.type) + "'");
+                        continue;
+                    }
+                    DebugPrint("CONFIG", "Loaded %s rule from %s", std::string(light.type).c_str(),
+                               result.fileName.c_str());
+                } else if (light.type == "HandheldLight") {
+                    config.handHeldLights.push_back(ToLightConfig<HandHeldLightConfig>(light));
+                    DebugPrint("CONFIG", "Loaded HandheldLight from %s", result.fileName.c_str());
+                } else if (light.type == "SpellLight") {
+                    config.spells.push_back(ToLightConfig<SpellConfig>(light));
+                    DebugPrint("CONFIG", "Loaded SpellLight from %s", result.fileName.c_str());
+                } else if (light.type == "EnchantmentLight") {
+                    config.enchantedArmors.push_back(ToLightConfig<EnchantedArmorConfig>(light));
+                    DebugPrint("CONFIG", "Loaded EnchantmentLight from %s", result.fileName.c_str());
+                } else {
+                    errors.push_back(result.fileName + ": unknown type '" + std::string(light.type) + "'");
+                    continue;
                 }
-                armor.plugin = ExtractValue(json, "plugin", 0);
-                armor.rootNodeName = ExtractValue(json, "rootNodeName", 0);
-                armor.lightNodeName = ExtractValue(json, "lightNodeName", 0);
-
-                std::string offsetX = ExtractValue(json, "offsetX", 0);
-                if (!offsetX.empty()) armor.offsetX = std::stof(offsetX);
-
-                std::string offsetY = ExtractValue(json, "offsetY", 0);
-                if (!offsetY.empty()) armor.offsetY = std::stof(offsetY);
-
-                std::string offsetZ = ExtractValue(json, "offsetZ", 0);
-                if (!offsetZ.empty()) armor.offsetZ = std::stof(offsetZ);
-
-                std::string rotateX = ExtractValue(json, "rotateX", 0);
-                if (!rotateX.empty()) armor.rotateX = std::stof(rotateX);
-
-                std::string rotateY = ExtractValue(json, "rotateY", 0);
-                if (!rotateY.empty()) armor.rotateY = std::stof(rotateY);
-
-                std::string rotateZ = ExtractValue(json, "rotateZ", 0);
-                if (!rotateZ.empty()) armor.rotateZ = std::stof(rotateZ);
-
-                g_config.enchantedArmors.push_back(armor);
-                DebugPrint("CONFIG", "Loaded EnchantmentLight from %s", entry.path().filename().string().c_str());
-
-            } else {
-                DebugPrint("CONFIG", "Warning: Unknown type '%s' in file %s", type.c_str(), filePath.c_str());
-                continue;
+                anyLoaded = true;
             }
 
-            fileCount++;
+            if (anyLoaded) {
+                fileCount++;
+            }
         }
 
-        DebugPrint("CONFIG", "Loaded %d light configuration files", fileCount);
+        DebugPrint("CONFIG", "Loaded %d light configuration files (%zu from cache)", fileCount, cachedCount);
         DebugPrint("CONFIG", "Total: %zu hand-held lights, %zu spells, %zu enchanted armors",
-                   g_config.handHeldLights.size(), g_config.spells.size(), g_config.enchantedArmors.size());
-    }
-
-    void ResolvePluginFormIDs() {
-        // Resolve plugin-based form IDs to runtime form IDs for handHeldLights
-        auto* dataHandler = RE::TESDataHandler::GetSingleton();
-        if (!dataHandler) {
-            DebugPrint("CONFIG", "Warning: Could not get TESDataHandler for plugin resolution");
-            return;
+                   config.handHeldLights.size(), config.spells.size(), config.enchantedArmors.size());
+        DebugPrint("CONFIG", "Rules: %zu hand-held light, %zu spell, %zu enchanted armor", config.handHeldLightRules.size(),
+                   config.spellRules.size(), config.enchantedArmorRules.size());
+
+        if (!errors.empty()) {
+            DebugPrint("CONFIG", "Warning: %zu configuration file(s) could not be loaded:", errors.size());
+            for (const auto& error : errors) {
+                DebugPrint("CONFIG", "  %s", error.c_str());
+            }
         }
 
-        for (auto& lightConfig : g_config.handHeldLights) {
-            if (!lightConfig.plugin.empty() && lightConfig.formId != 0) {
-                uint32_t originalLocalFormId = lightConfig.formId;
-                auto* light = dataHandler->LookupForm<RE::TESObjectLIGH>(lightConfig.formId, lightConfig.plugin);
-                if (light) {
-                    lightConfig.formId = light->GetFormID();
-                    DebugPrint("CONFIG", "Resolved handHeldLight %s|0x%06X to runtime FormID 0x%08X",
-                               lightConfig.plugin.c_str(), originalLocalFormId, lightConfig.formId);
-                } else {
-                    DebugPrint("CONFIG", "Warning: HandHeldLight %s|0x%06X not found", lightConfig.plugin.c_str(),
-                               originalLocalFormId);
-                }
+        // Recompile the cache if any file was added, changed, touched or removed. Only stale files were parsed
+        // above, so the rewrite just serializes records already in memory; the packed layout cannot be patched
+        // in place once a record's string data changes length.
+        if (staleRecordCount > 0 || cache.FileCount() != results.size()) {
+            ConfigCacheWriter writer;
+            for (const auto& result : results) {
+                writer.AddFile(result.fileName, result.fingerprint, result.lights, result.error);
             }
-        }
 
-        // Resolve plugin-based form IDs for enchantedArmors
-        for (auto& armorConfig : g_config.enchantedArmors) {
-            if (!armorConfig.plugin.empty() && armorConfig.formId != 0) {
-                uint32_t originalLocalFormId = armorConfig.formId;
-                auto* armor = dataHandler->LookupForm<RE::TESObjectARMO>(armorConfig.formId, armorConfig.plugin);
-                if (armor) {
-                    armorConfig.formId = armor->GetFormID();
-                    DebugPrint("CONFIG", "Resolved enchantedArmor %s|0x%06X to runtime FormID 0x%08X",
-                               armorConfig.plugin.c_str(), originalLocalFormId, armorConfig.formId);
-                } else {
-                    DebugPrint("CONFIG", "Warning: EnchantedArmor %s|0x%06X not found", armorConfig.plugin.c_str(),
-                               originalLocalFormId);
-                }
+            // The mapping must be released before the cache file can be replaced
+            cache.Close();
+            if (writer.Write(kConfigCachePath)) {
+                DebugPrint("CONFIG", "Rebuilt config cache (%zu files)", results.size());
+            } else {
+                DebugPrint("CONFIG", "Warning: Could not write config cache %s", kConfigCachePath);
             }
         }
     }
 
-    void LoadConfig() {
-        // Load JSON first
-        LoadJsonConfig();
+    static void LoadIniConfig(Config& config) {
         std::string iniPath = "Data/SKSE/Plugins/ActorShadows.ini";
         std::ifstream file(iniPath);
 
         if (!file.is_open()) {
             // Use defaults if file doesn't exist
+            SetDebugEnabled(config.enableDebug);
             DebugPrint("CONFIG", "ActorShadows.ini not found, using defaults");
             return;
         }
@@ -367,61 +396,101 @@ namespace ActorShadowLimiter {
 
             // Parse settings
             if (key == "ShadowLightLimit") {
-                g_config.shadowLightLimit = std::stoi(value);
+                config.shadowLightLimit = std::stoi(value);
             } else if (key == "ShadowLightLimitExterior") {
-                g_config.shadowLightLimitExterior = std::stoi(value);
+                config.shadowLightLimitExterior = std::stoi(value);
             } else if (key == "EnableDebug") {
-                g_config.enableDebug = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableDebug = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "PollIntervalSeconds") {
                 try {
-                    g_config.pollIntervalSeconds = std::stoi(value);
+                    config.pollIntervalSeconds = std::stoi(value);
                 } catch (...) {
                     // Keep default
                 }
             } else if (key == "EnableInterior") {
-                g_config.enableInterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableInterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "EnableExterior") {
-                g_config.enableExterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableExterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "EnableNpc") {
-                g_config.enableNpc = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableNpc = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "EnableNpcInterior") {
-                g_config.enableNpcInterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableNpcInterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "EnableNpcExterior") {
-                g_config.enableNpcExterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableNpcExterior = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "ShadowDistanceSafetyMargin") {
                 try {
-                    g_config.shadowDistanceSafetyMargin = std::stof(value);
+                    config.shadowDistanceSafetyMargin = std::stof(value);
                 } catch (...) {
                     // Keep default
                 }
             } else if (key == "NpcMaxDistance") {
                 try {
-                    g_config.npcMaxDistance = std::stof(value);
+                    config.npcMaxDistance = std::stof(value);
                 } catch (...) {
                     // Keep default
                 }
             } else if (key == "EnableDuplicateFix") {
-                g_config.enableDuplicateFix = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+                config.enableDuplicateFix = (value == "true" || value == "1" || value == "True" || value == "TRUE");
             } else if (key == "DuplicateRemovalIntervalMs") {
                 try {
-                    g_config.duplicateRemovalIntervalMs = std::stoi(value);
+                    config.duplicateRemovalIntervalMs = std::stoi(value);
                 } catch (...) {
                     // Keep default
                 }
+            } else if (key == "EnableConfigHotReload") {
+                config.enableConfigHotReload = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+            } else if (key == "ConfigReloadIntervalSeconds") {
+                try {
+                    config.configReloadIntervalSeconds = std::stoi(value);
+                } catch (...) {
+                    // Keep default
+                }
+            } else if (key == "EnableFrameUpdate") {
+                config.enableFrameUpdate = (value == "true" || value == "1" || value == "True" || value == "TRUE");
+            } else if (key == "FrameUpdateBudgetMicroseconds") {
+                try {
+                    // Below the floor a frame could not finish even one actor, above it one frame would stutter
+                    config.frameUpdateBudgetMicroseconds = std::clamp(
+                        std::stoi(value), kMinFrameUpdateBudgetMicroseconds, kMaxFrameUpdateBudgetMicroseconds);
+                } catch (...) {
+                    // Keep default
+                }
+            } else if (key == "FrameUpdateIntervalMs") {
+                try {
+                    config.frameUpdateIntervalMs = std::stoi(value);
+                } catch (...) {
+                    // Keep default
+                }
+            } else if (key == "ShadowHysteresisDistance") {
+                try {
+                    config.shadowHysteresisDistance = std::stof(value);
+                } catch (...) {
+                    // Keep default
+                }
+            } else if (key == "MinShadowDwellSeconds") {
+                try {
+                    config.minShadowDwellSeconds = std::stof(value);
+                } catch (...) {
+                    // Keep default
+                }
+            } else if (key == "EnableMotionPrediction") {
+                config.enableMotionPrediction =
+                    (value == "true" || value == "1" || value == "True" || value == "TRUE");
             }
         }
 
         file.close();
+        SetDebugEnabled(config.enableDebug);
 
         // Fetch shadow distances from game INI settings.
         // These are used to calculate exact render distances, combined with light radius values and some safety margin.
         auto* prefSettings = RE::INIPrefSettingCollection::GetSingleton();
         if (prefSettings) {
             if (auto* setting = prefSettings->GetSetting("fInteriorShadowDistance:Display")) {
-                g_config.shadowDistanceInterior = setting->GetFloat();
+                config.shadowDistanceInterior = setting->GetFloat();
             }
             if (auto* setting = prefSettings->GetSetting("fShadowDistance:Display")) {
-                g_config.shadowDistanceExterior = setting->GetFloat();
+                config.shadowDistanceExterior = setting->GetFloat();
             }
         }
 
@@ -433,70 +502,30 @@ namespace ActorShadowLimiter {
                    "  Interior: %s, Exterior: %s\n"
                    "  NPC: %s (Interior: %s, Exterior: %s)\n"
                    "  Shadow Distance Safety Margin: %.1f\n"
-                   "  Duplicate Fix: %s (Interval: %dms)",
-                   g_config.shadowLightLimit, g_config.shadowLightLimitExterior, g_config.pollIntervalSeconds,
-                   g_config.enableDebug ? "ON" : "OFF", g_config.enableInterior ? "ON" : "OFF",
-                   g_config.enableExterior ? "ON" : "OFF", g_config.enableNpc ? "ON" : "OFF",
-                   g_config.enableNpcInterior ? "ON" : "OFF", g_config.enableNpcExterior ? "ON" : "OFF",
-                   g_config.shadowDistanceSafetyMargin, g_config.enableDuplicateFix ? "ON" : "OFF",
-                   g_config.duplicateRemovalIntervalMs);
-
-        // Resolve plugin-based form IDs to runtime form IDs
-        ResolvePluginFormIDs();
+                   "  Duplicate Fix: %s (Interval: %dms)\n"
+                   "  Config Hot Reload: %s (Interval: %d seconds)\n"
+                   "  Frame Update: %s (Budget: %dus, Interval: %dms)\n"
+                   "  Hysteresis: %.1f, Min Dwell: %.1f seconds, Motion Prediction: %s",
+                   config.shadowLightLimit, config.shadowLightLimitExterior, config.pollIntervalSeconds,
+                   config.enableDebug ? "ON" : "OFF", config.enableInterior ? "ON" : "OFF",
+                   config.enableExterior ? "ON" : "OFF", config.enableNpc ? "ON" : "OFF",
+                   config.enableNpcInterior ? "ON" : "OFF", config.enableNpcExterior ? "ON" : "OFF",
+                   config.shadowDistanceSafetyMargin, config.enableDuplicateFix ? "ON" : "OFF",
+                   config.duplicateRemovalIntervalMs, config.enableConfigHotReload ? "ON" : "OFF",
+                   config.configReloadIntervalSeconds, config.enableFrameUpdate ? "ON" : "OFF",
+                   config.frameUpdateBudgetMicroseconds, config.frameUpdateIntervalMs,
+                   config.shadowHysteresisDistance, config.minShadowDwellSeconds,
+                   config.enableMotionPrediction ? "ON" : "OFF");
     }
 
-    void BuildEffectToSpellMapping() {
-        // Build mapping from configured spells to their light-emitting effects
-        // This allows us to detect which configured spells are active by checking magic effects
-        for (auto& spellConfig : g_config.spells) {
-            if (spellConfig.formId == 0) continue;
-
-            RE::SpellItem* spell = nullptr;
-            uint32_t originalLocalFormId = spellConfig.formId;
-
-            // If plugin is specified, use plugin-based lookup
-            if (!spellConfig.plugin.empty()) {
-                auto* dataHandler = RE::TESDataHandler::GetSingleton();
-                if (dataHandler) {
-                    spell = dataHandler->LookupForm<RE::SpellItem>(spellConfig.formId, spellConfig.plugin);
-                    if (spell) {
-                        // Update formId to runtime ID for faster comparisons later
-                        spellConfig.formId = spell->GetFormID();
-                        DebugPrint("CONFIG", "Resolved %s|0x%06X to runtime FormID 0x%08X", spellConfig.plugin.c_str(),
-                                   originalLocalFormId, spell->GetFormID());
-                    }
-                }
-            } else {
-                // Use direct formId lookup
-                spell = RE::TESForm::LookupByID<RE::SpellItem>(spellConfig.formId);
-            }
-
-            if (!spell || spell->effects.size() == 0) {
-                if (!spellConfig.plugin.empty()) {
-                    DebugPrint("CONFIG", "Warning: Spell %s|0x%06X not found or has no effects",
-                               spellConfig.plugin.c_str(), originalLocalFormId);
-                } else {
-                    DebugPrint("CONFIG", "Warning: Spell FormID 0x%08X not found or has no effects",
-                               spellConfig.formId);
-                }
-                continue;
-            }
-
-            // Find effects with associated lights
-            for (auto* effect : spell->effects) {
-                if (!effect || !effect->baseEffect) continue;
-                auto* assocForm = effect->baseEffect->data.associatedForm;
-                if (!assocForm) continue;
-
-                auto* asLight = assocForm->As<RE::TESObjectLIGH>();
-                if (asLight) {
-                    DebugPrint("CONFIG", "Mapped effect 0x%08X -> spell 0x%08X", effect->baseEffect->GetFormID(),
-                               spellConfig.formId);
-                }
-            }
-        }
+    void LoadConfig(Config& config) {
+        // Read the INI first so EnableDebug applies to the JSON load report. It is not cached: one short file of
+        // settings reads in well under a millisecond, and a cache record would have to mirror every Config field.
+        LoadIniConfig(config);
+        LoadJsonConfig(config);
 
-        DebugPrint("CONFIG", "Built effect-to-spell mapping for %zu configured spells", g_config.spells.size());
+        // Resolve plugin-based form IDs of lights, spells and armors to runtime form IDs
+        ResolvePluginFormIDs(config);
     }
 
-}
+}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -43,6 +44,22 @@ namespace ActorShadowLimiter {
         float rotateZ = 0.0f;
     };
 
+    /**
+     * Filters of a rule entry. A rule matches every loaded form of its config type that passes all
+     * filters, so one entry can cover a whole lighting mod.
+     */
+    struct LightMatchRule {
+        std::string plugin;      // Only forms defined by this plugin, empty for any
+        std::string keyword;     // Only forms carrying this keyword editor ID, empty for any
+        float minRadius = 0.0f;  // Only forms whose light has at least this radius
+    };
+
+    template <class T>
+    struct RuleConfig {
+        LightMatchRule match;
+        T config;  // Node names and transforms shared by every matched form, formId is unused
+    };
+
     struct Config {
         int shadowLightLimit = 4;
         int shadowLightLimitExterior = 3;
@@ -59,15 +76,37 @@ namespace ActorShadowLimiter {
         int duplicateRemovalIntervalMs = 2000;
         float shadowDistanceInterior = 3000.0f;
         float shadowDistanceExterior = 3000.0f;
+        bool enableConfigHotReload = false;
+        int configReloadIntervalSeconds = 2;
+        bool enableFrameUpdate = false;
+        int frameUpdateBudgetMicroseconds = 300;
+        int frameUpdateIntervalMs = 250;
+        float shadowHysteresisDistance = 250.0f;
+        float minShadowDwellSeconds = 3.0f;
+        bool enableMotionPrediction = true;
 
         std::vector<HandHeldLightConfig> handHeldLights;
         std::vector<SpellConfig> spells;
         std::vector<EnchantedArmorConfig> enchantedArmors;
+
+        std::vector<RuleConfig<HandHeldLightConfig>> handHeldLightRules;
+        std::vector<RuleConfig<SpellConfig>> spellRules;
+        std::vector<RuleConfig<EnchantedArmorConfig>> enchantedArmorRules;
+
+        // Actors keep shadows they already have out to here, new shadows stay within NpcMaxDistance
+        float GetNpcExitDistance() const { return npcMaxDistance + std::max(shadowHysteresisDistance, 0.0f); }
     };
 
-    extern Config g_config;
-    void LoadConfig();
-    void BuildEffectToSpellMapping();
+    /**
+     * Config of the current snapshot, for main-thread code. Background threads must hold a
+     * snapshot from AcquireConfigSnapshot() instead, as a reload frees the previous one.
+     */
+    const Config& GetConfig();
+
+    /**
+     * Reads the INI and JSON files into `config` and resolves plugin form IDs to runtime IDs.
+     */
+    void LoadConfig(Config& config);
     bool IsInConfig(RE::TESObjectLIGH* lightBase);
     bool IsInConfig(RE::SpellItem* spell);
     bool IsInConfig(RE::TESObjectARMO* armor);
@@ -0,0 +1,191 @@
+#include "ConfigCache.h"
+
+#include <fstream>
+#include <type_traits>
+
+namespace ActorShadowLimiter {
+
+    namespace {
+        constexpr std::uint32_t kCacheMagic = 0x43435341;  // "ASCC"
+        constexpr std::uint32_t kCacheVersion = 3;
+
+        constexpr std::uint32_t kLightFlagRule = 1u << 0;
+
+        static_assert(std::is_trivially_copyable_v<CachedConfigHeader> && sizeof(CachedConfigHeader) == 32);
+        static_assert(std::is_trivially_copyable_v<CachedConfigFile> && sizeof(CachedConfigFile) == 48);
+        static_assert(std::is_trivially_copyable_v<CachedLightRecord> && sizeof(CachedLightRecord) == 80);
+    }
+
+    bool ConfigCacheReader::Open(const std::filesystem::path& path) {
+        Close();
+        if (!mapping_.Open(path)) {
+            return false;
+        }
+
+        const std::byte* data = mapping_.Data();
+        size_t size = mapping_.Size();
+        if (size < sizeof(CachedConfigHeader)) {
+            Close();
+            return false;
+        }
+
+        auto* header = reinterpret_cast<const CachedConfigHeader*>(data);
+        size_t expectedSize = sizeof(CachedConfigHeader) + size_t{header->fileCount} * sizeof(CachedConfigFile) +
+                              size_t{header->lightCount} * sizeof(CachedLightRecord) + header->stringPoolSize;
+        if (header->magic != kCacheMagic || header->version != kCacheVersion || expectedSize != size) {
+            Close();
+            return false;
+        }
+
+        header_ = header;
+        files_ = reinterpret_cast<const CachedConfigFile*>(data + sizeof(CachedConfigHeader));
+        lights_ = reinterpret_cast<const CachedLightRecord*>(files_ + header->fileCount);
+        stringPool_ = reinterpret_cast<const char*>(lights_ + header->lightCount);
+
+        filesByName_.reserve(header->fileCount);
+        for (uint32_t i = 0; i < header->fileCount; ++i) {
+            std::string_view name;
+            if (!GetString(files_[i].name, name)) {
+                Close();
+                return false;
+            }
+            filesByName_.emplace(name, &files_[i]);
+        }
+        return true;
+    }
+
+    void ConfigCacheReader::Close() {
+        filesByName_.clear();
+        header_ = nullptr;
+        files_ = nullptr;
+        lights_ = nullptr;
+        stringPool_ = nullptr;
+        mapping_.Close();
+    }
+
+    bool ConfigCacheReader::GetString(CachedStringRef ref, std::string_view& out) const {
+        if (size_t{ref.offset} + ref.length > header_->stringPoolSize) {
+            return false;
+        }
+        out = std::string_view(stringPool_ + ref.offset, ref.length);
+        return true;
+    }
+
+    const CachedConfigFile* ConfigCacheReader::FindFile(std::string_view name) const {
+        auto it = filesByName_.find(name);
+        return it != filesByName_.end() ? it->second : nullptr;
+    }
+
+    bool ConfigCacheReader::ReadFile(const CachedConfigFile& file, std::vector<ParsedLightEntry>& lights,
+                                     std::string& error) const {
+        if (size_t{file.firstLight} + file.lightCount > header_->lightCount) {
+            return false;
+        }
+
+        std::string_view cachedError;
+        if (!GetString(file.error, cachedError)) {
+            return false;
+        }
+        error = cachedError;
+
+        lights.clear();
+        lights.reserve(file.lightCount);
+        for (uint32_t i = 0; i < file.lightCount; ++i) {
+            const auto& record = lights_[file.firstLight + i];
+            ParsedLightEntry light;
+            if (!GetString(record.type, light.type) || !GetString(record.plugin, light.plugin) ||
+                !GetString(record.rootNodeName, light.rootNodeName) ||
+                !GetString(record.lightNodeName, light.lightNodeName) || !GetString(record.keyword, light.keyword)) {
+                return false;
+            }
+            light.formId = record.formId;
+            light.offsetX = record.offset[0];
+            light.offsetY = record.offset[1];
+            light.offsetZ = record.offset[2];
+            light.rotateX = record.rotate[0];
+            light.rotateY = record.rotate[1];
+            light.rotateZ = record.rotate[2];
+            light.isRule = (record.flags & kLightFlagRule) != 0;
+            light.minRadius = record.minRadius;
+            lights.push_back(light);
+        }
+        return true;
+    }
+
+    CachedStringRef ConfigCacheWriter::AddString(std::string_view value) {
+        // Plugin and node names repeat across most files, store each distinct string once
+        auto it = internedStrings_.find(std::string(value));
+        if (it != internedStrings_.end()) {
+            return it->second;
+        }
+
+        CachedStringRef ref{static_cast<uint32_t>(stringPool_.size()), static_cast<uint32_t>(value.size())};
+        stringPool_.append(value);
+        internedStrings_.emplace(std::string(value), ref);
+        return ref;
+    }
+
+    void ConfigCacheWriter::AddFile(std::string_view name, const ConfigFileFingerprint& fingerprint,
+                                    const std::vector<ParsedLightEntry>& lights, std::string_view error) {
+        CachedConfigFile file;
+        file.name = AddString(name);
+        file.error = AddString(error);
+        file.size = fingerprint.size;
+        file.lastWriteTime = fingerprint.lastWriteTime;
+        file.contentHash = fingerprint.contentHash;
+        file.firstLight = static_cast<uint32_t>(lights_.size());
+        file.lightCount = static_cast<uint32_t>(lights.size());
+        files_.push_back(file);
+
+        for (const auto& light : lights) {
+            CachedLightRecord record;
+            record.type = AddString(light.type);
+            record.plugin = AddString(light.plugin);
+            record.rootNodeName = AddString(light.rootNodeName);
+            record.lightNodeName = AddString(light.lightNodeName);
+            record.keyword = AddString(light.keyword);
+            record.formId = light.formId;
+            record.offset[0] = light.offsetX;
+            record.offset[1] = light.offsetY;
+            record.offset[2] = light.offsetZ;
+            record.rotate[0] = light.rotateX;
+            record.rotate[1] = light.rotateY;
+            record.rotate[2] = light.rotateZ;
+            record.minRadius = light.minRadius;
+            record.flags = light.isRule ? kLightFlagRule : 0;
+            lights_.push_back(record);
+        }
+    }
+
+    bool ConfigCacheWriter::Write(const std::filesystem::path& path) const {
+        CachedConfigHeader header;
+        header.magic = kCacheMagic;
+        header.version = kCacheVersion;
+        header.fileCount = static_cast<uint32_t>(files_.size());
+        header.lightCount = static_cast<uint32_t>(lights_.size());
+        header.stringPoolSize = static_cast<uint32_t>(stringPool_.size());
+
+        // Write next to the target and swap in, so a crash mid-write never leaves a torn cache
+        auto tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                return false;
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(files_.data()),
+                      static_cast<std::streamsize>(files_.size() * sizeof(CachedConfigFile)));
+            out.write(reinterpret_cast<const char*>(lights_.data()),
+                      static_cast<std::streamsize>(lights_.size() * sizeof(CachedLightRecord)));
+            out.write(stringPool_.data(), static_cast<std::streamsize>(stringPool_.size()));
+            if (!out) {
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        return !ec;
+    }
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "../utils/MappedFile.h"
+#include "JsonParser.h"
+
+namespace ActorShadowLimiter {
+
+    struct ConfigFileFingerprint {
+        std::uint64_t size = 0;
+        std::int64_t lastWriteTime = 0;
+        std::uint64_t contentHash = 0;
+    };
+
+    // On-disk layout: header, file records, light records, string pool. All records are fixed size.
+    struct CachedStringRef {
+        std::uint32_t offset = 0;
+        std::uint32_t length = 0;
+    };
+
+    struct CachedConfigHeader {
+        std::uint32_t magic = 0;
+        std::uint32_t version = 0;
+        std::uint32_t fileCount = 0;
+        std::uint32_t lightCount = 0;
+        std::uint32_t stringPoolSize = 0;
+        std::uint32_t reserved[3] = {};
+    };
+
+    struct CachedConfigFile {
+        CachedStringRef name;
+        CachedStringRef error;  // Empty unless the file failed to load
+        std::uint64_t size = 0;
+        std::int64_t lastWriteTime = 0;
+        std::uint64_t contentHash = 0;
+        std::uint32_t firstLight = 0;
+        std::uint32_t lightCount = 0;
+    };
+
+    struct CachedLightRecord {
+        CachedStringRef type;
+        CachedStringRef plugin;
+        CachedStringRef rootNodeName;
+        CachedStringRef lightNodeName;
+        CachedStringRef keyword;
+        std::uint32_t formId = 0;
+        float offset[3] = {};
+        float rotate[3] = {};
+        float minRadius = 0.0f;
+        std::uint32_t flags = 0;
+        std::uint32_t reserved = 0;
+    };
+
+    /**
+     * Read side of the compiled config cache. Entries returned from here point into the mapping
+     * and are only valid while the cache stays open.
+     */
+    class ConfigCacheReader {
+    public:
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const { return header_ != nullptr; }
+        std::uint32_t FileCount() const { return header_ ? header_->fileCount : 0; }
+
+        const CachedConfigFile* FindFile(std::string_view name) const;
+        bool ReadFile(const CachedConfigFile& file, std::vector<ParsedLightEntry>& lights, std::string& error) const;
+
+    private:
+        bool GetString(CachedStringRef ref, std::string_view& out) const;
+
+        MappedFile mapping_;
+        const CachedConfigHeader* header_ = nullptr;
+        const CachedConfigFile* files_ = nullptr;
+        const CachedLightRecord* lights_ = nullptr;
+        const char* stringPool_ = nullptr;
+        std::unordered_map<std::string_view, const CachedConfigFile*> filesByName_;
+    };
+
+    /**
+     * Write side of the compiled config cache. Copies all strings, so inputs may be released
+     * before Write() is called.
+     */
+    class ConfigCacheWriter {
+    public:
+        void AddFile(std::string_view name, const ConfigFileFingerprint& fingerprint,
+                     const std::vector<ParsedLightEntry>& lights, std::string_view error);
+        bool Write(const std::filesystem::path& path) const;
+
+    private:
+        CachedStringRef AddString(std::string_view value);
+
+        std::vector<CachedConfigFile> files_;
+        std::vector<CachedLightRecord> lights_;
+        std::string stringPool_;
+        std::unordered_map<std::string, CachedStringRef> internedStrings_;
+    };
+}
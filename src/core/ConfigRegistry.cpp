@@ -0,0 +1,125 @@
+#include "ConfigRegistry.h"
+
+#include "../utils/Console.h"
+#include "../utils/Light.h"
+#include "LightRules.h"
+
+namespace ActorShadowLimiter {
+
+    void ConfigRegistry::Build(const Config& config) {
+        // Rules are expanded to concrete forms up front, lookups stay a single probe either way
+        std::vector<ConfigLookup> ruleMatches;
+        CollectRuleMatches(config, ruleMatches);
+
+        size_t explicitCount = config.handHeldLights.size() + config.spells.size() + config.enchantedArmors.size();
+        size_t count = explicitCount + ruleMatches.size();
+
+        // Keep the load factor at or below 0.5 so probe sequences stay short
+        size_t capacity = 16;
+        while (capacity < count * 2) {
+            capacity <<= 1;
+        }
+
+        slots_.assign(capacity, Slot{});
+        entries_.clear();
+        entries_.reserve(count);
+        mask_ = capacity - 1;
+
+        auto insertExplicit = [this](uint32_t formId, ConfigType type, const void* entryConfig) {
+            if (formId != 0 && !Insert({formId, type, entryConfig})) {
+                // First config wins, matching the order the linear scans used to resolve in
+                DebugPrint("CONFIG", "Warning: Form 0x%08X configured more than once, keeping first entry", formId);
+            }
+        };
+        for (const auto& light : config.handHeldLights) {
+            insertExplicit(light.formId, ConfigType::HandheldLight, &light);
+        }
+        for (const auto& spell : config.spells) {
+            insertExplicit(spell.formId, ConfigType::SpellLight, &spell);
+        }
+        for (const auto& armor : config.enchantedArmors) {
+            insertExplicit(armor.formId, ConfigType::EnchantmentLight, &armor);
+        }
+
+        // Resolve the game forms once so callers never have to walk effects again
+        size_t resolvedLights = 0;
+        for (auto& entry : entries_) {
+            entry.form = RE::TESForm::LookupByID(entry.formId);
+            if (!entry.form) {
+                continue;
+            }
+            switch (entry.type) {
+                case ConfigType::HandheldLight:
+                    entry.light = entry.form->As<RE::TESObjectLIGH>();
+                    break;
+                case ConfigType::SpellLight:
+                    entry.light = GetAssociatedLight(entry.form->As<RE::SpellItem>());
+                    break;
+                case ConfigType::EnchantmentLight:
+                    if (auto* armor = entry.form->As<RE::TESObjectARMO>()) {
+                        entry.light = GetAssociatedLight(armor->formEnchanting);
+                    }
+                    break;
+                default:
+                    break;
+            }
+            if (entry.light) {
+                ++resolvedLights;
+            } else {
+                DebugPrint("CONFIG", "Warning: No light base form found for configured form 0x%08X", entry.formId);
+            }
+        }
+
+        // Rule matches arrive resolved, explicit entries take precedence over them
+        size_t ruleCount = 0;
+        for (const auto& match : ruleMatches) {
+            if (Insert(match)) {
+                ++ruleCount;
+            }
+        }
+
+        DebugPrint("CONFIG", "Built config registry with %zu forms (%zu from rules), %zu with lights (%zu slots)",
+                   entries_.size(), ruleCount, resolvedLights + ruleCount, capacity);
+    }
+
+    void ConfigRegistry::Clear() {
+        slots_.clear();
+        entries_.clear();
+        mask_ = 0;
+    }
+
+    size_t ConfigRegistry::SlotIndex(uint32_t formId) const {
+        // Fibonacci hashing spreads the load-order byte and sequential local IDs across the table
+        return static_cast<size_t>((static_cast<uint64_t>(formId) * 0x9E3779B97F4A7C15ull) >> 32) & mask_;
+    }
+
+    bool ConfigRegistry::Insert(const ConfigLookup& entry) {
+        for (size_t i = SlotIndex(entry.formId);; i = (i + 1) & mask_) {
+            auto& slot = slots_[i];
+            if (slot.formId == entry.formId) {
+                return false;
+            }
+            if (slot.formId == 0) {
+                slot = {entry.formId, static_cast<uint32_t>(entries_.size())};
+                entries_.push_back(entry);
+                return true;
+            }
+        }
+    }
+
+    ConfigLookup ConfigRegistry::Find(uint32_t formId) const {
+        if (formId == 0 || slots_.empty()) {
+            return {};
+        }
+
+        for (size_t i = SlotIndex(formId);; i = (i + 1) & mask_) {
+            const auto& slot = slots_[i];
+            if (slot.formId == formId) {
+                return entries_[slot.entryIndex];
+            }
+            if (slot.formId == 0) {
+                return {};
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Config.h"
+
+namespace ActorShadowLimiter {
+
+    enum class ConfigType : std::uint8_t { None = 0, HandheldLight, SpellLight, EnchantmentLight };
+
+    /**
+     * Result of a registry lookup: the kind of configured form, a pointer to its config entry and
+     * the game forms resolved for it once after data load.
+     */
+    struct ConfigLookup {
+        uint32_t formId = 0;
+        ConfigType type = ConfigType::None;
+        const void* config = nullptr;
+        RE::TESForm* form = nullptr;         // The configured light, spell or armor, null if not loaded
+        RE::TESObjectLIGH* light = nullptr;  // Light base form it spawns, null if none was found
+
+        explicit operator bool() const { return type != ConfigType::None; }
+
+        const HandHeldLightConfig* AsHandHeldLight() const {
+            return type == ConfigType::HandheldLight ? static_cast<const HandHeldLightConfig*>(config) : nullptr;
+        }
+        const SpellConfig* AsSpell() const {
+            return type == ConfigType::SpellLight ? static_cast<const SpellConfig*>(config) : nullptr;
+        }
+        const EnchantedArmorConfig* AsEnchantedArmor() const {
+            return type == ConfigType::EnchantmentLight ? static_cast<const EnchantedArmorConfig*>(config) : nullptr;
+        }
+    };
+
+    /**
+     * Flat open-addressing table from runtime FormID to config entry, covering all configured
+     * lights, spells and armors plus every form matched by a rule entry. Must be rebuilt whenever
+     * the config vectors change, since it points into them.
+     */
+    class ConfigRegistry {
+    public:
+        void Build(const Config& config);
+        void Clear();
+
+        ConfigLookup Find(uint32_t formId) const;
+        std::span<const ConfigLookup> Entries() const { return entries_; }
+        size_t Size() const { return entries_.size(); }
+
+    private:
+        struct Slot {
+            uint32_t formId = 0;  // 0 marks an empty slot, never a valid configured form
+            uint32_t entryIndex = 0;
+        };
+
+        bool Insert(const ConfigLookup& entry);  // False if the form is already present
+        size_t SlotIndex(uint32_t formId) const;
+
+        std::vector<Slot> slots_;
+        std::vector<ConfigLookup> entries_;
+        size_t mask_ = 0;
+    };
+
+    /**
+     * Registry of the current config snapshot.
+     */
+    const ConfigRegistry& GetConfigRegistry();
+}
@@ -0,0 +1,119 @@
+#include "ConfigStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <thread>
+
+#include "../utils/Console.h"
+#include "../utils/Hash.h"
+#include "SKSE/SKSE.h"
+
+namespace ActorShadowLimiter {
+
+    static const auto g_defaultSnapshot = std::make_shared<const ConfigSnapshot>();
+
+    // Owns the current snapshot. Background threads copy it, so a replaced snapshot lives on until
+    // their last read finished, and is freed right away otherwise.
+    static std::atomic<std::shared_ptr<const ConfigSnapshot>> g_currentSnapshot{g_defaultSnapshot};
+
+    // Same snapshot without reference counting for main-thread readers. Main-thread code never
+    // holds it across a reload, since reloads run on the main thread too.
+    static std::atomic<const ConfigSnapshot*> g_mainThreadSnapshot{g_defaultSnapshot.get()};
+    static std::uint64_t g_snapshotVersion = 0;  // Main thread only
+
+    static std::atomic<bool> g_configWatcherRunning{false};
+
+    const ConfigSnapshot& GetConfigSnapshot() { return *g_mainThreadSnapshot.load(std::memory_order_acquire); }
+
+    std::shared_ptr<const ConfigSnapshot> AcquireConfigSnapshot() {
+        return g_currentSnapshot.load(std::memory_order_acquire);
+    }
+
+    const Config& GetConfig() { return GetConfigSnapshot().config; }
+
+    const ConfigRegistry& GetConfigRegistry() { return GetConfigSnapshot().registry; }
+
+    const EffectSpellIndex& GetEffectSpellIndex() { return GetConfigSnapshot().effectIndex; }
+
+    void ReloadConfig() {
+        auto snapshot = std::make_shared<ConfigSnapshot>();
+        snapshot->version = ++g_snapshotVersion;
+        LoadConfig(snapshot->config);
+
+        // The indices point into the snapshot's own config, so build them in place
+        snapshot->registry.Build(snapshot->config);
+        snapshot->effectIndex.Build(snapshot->registry);
+
+        DebugPrint("CONFIG", "Published config snapshot v%llu",
+                   static_cast<unsigned long long>(snapshot->version));
+        g_mainThreadSnapshot.store(snapshot.get(), std::memory_order_release);
+        g_currentSnapshot.store(std::move(snapshot), std::memory_order_release);
+    }
+
+    /**
+     * Cheap fingerprint of every config source: names, sizes and timestamps, no file contents.
+     */
+    static std::uint64_t ComputeConfigSourcesFingerprint() {
+        std::uint64_t hash = kFnv1aOffsetBasis;
+        auto addFile = [&hash](const std::filesystem::path& path, std::error_code& ec) {
+            auto size = std::filesystem::file_size(path, ec);
+            auto time = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+            hash = Fnv1a64(path.filename().string(), hash);
+            hash = Fnv1a64(std::string_view(reinterpret_cast<const char*>(&size), sizeof(size)), hash);
+            hash = Fnv1a64(std::string_view(reinterpret_cast<const char*>(&time), sizeof(time)), hash);
+        };
+
+        std::error_code ec;
+        addFile("Data/SKSE/Plugins/ActorShadows.ini", ec);
+        for (const auto& entry : std::filesystem::directory_iterator("Data/SKSE/Plugins/ActorShadows", ec)) {
+            if (entry.path().extension() == ".json") {
+                addFile(entry.path(), ec);
+            }
+        }
+        return hash;
+    }
+
+    void StartConfigWatcher() {
+        if (!GetConfig().enableConfigHotReload) return;
+
+        bool expected = false;
+        if (!g_configWatcherRunning.compare_exchange_strong(expected, true)) {
+            return;
+        }
+
+        std::thread([]() {
+            std::uint64_t lastFingerprint = ComputeConfigSourcesFingerprint();
+
+            while (g_configWatcherRunning) {
+                auto interval = std::max(1, AcquireConfigSnapshot()->config.configReloadIntervalSeconds);
+                std::this_thread::sleep_for(std::chrono::seconds(interval));
+                if (!g_configWatcherRunning) {
+                    break;
+                }
+
+                // Only the file metadata is read here, the reload itself touches game forms
+                std::uint64_t fingerprint = ComputeConfigSourcesFingerprint();
+                if (fingerprint == lastFingerprint) {
+                    continue;
+                }
+                lastFingerprint = fingerprint;
+
+                DebugPrint("CONFIG", "Config sources changed, queueing reload");
+                if (auto* tasks = SKSE::GetTaskInterface()) {
+                    tasks->AddTask([]() {
+                        ReloadConfig();
+                        if (!GetConfig().enableConfigHotReload) {
+                            StopConfigWatcher();
+                        }
+                    });
+                }
+            }
+            DebugPrint("CONFIG", "Config watcher stopped");
+        }).detach();
+        DebugPrint("CONFIG", "Config watcher started (%ds interval)", GetConfig().configReloadIntervalSeconds);
+    }
+
+    void StopConfigWatcher() { g_configWatcherRunning = false; }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "Config.h"
+#include "ConfigRegistry.h"
+#include "EffectIndex.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Immutable, versioned view of everything derived from the config files. A snapshot is freed
+     * once it was replaced and no background thread holds it anymore.
+     */
+    struct ConfigSnapshot {
+        std::uint64_t version = 0;
+        Config config;
+        ConfigRegistry registry;
+        EffectSpellIndex effectIndex;
+    };
+
+    /**
+     * Current snapshot for main-thread code. Reloads run on the main thread as well, so the
+     * reference stays valid until the caller returns to the game.
+     */
+    const ConfigSnapshot& GetConfigSnapshot();
+
+    /**
+     * Current snapshot for background threads, kept alive for as long as the caller holds it.
+     */
+    std::shared_ptr<const ConfigSnapshot> AcquireConfigSnapshot();
+
+    /**
+     * Loads the config from disk into a new snapshot and publishes it. Main thread only, as it
+     * resolves forms and scans the data handler.
+     */
+    void ReloadConfig();
+
+    /**
+     * Starts the background thread that watches the config sources and queues a reload on the
+     * main thread when any of them changes. Does nothing unless EnableConfigHotReload is set.
+     */
+    void StartConfigWatcher();
+    void StopConfigWatcher();
+}
@@ -0,0 +1,51 @@
+#include "EffectIndex.h"
+
+#include <algorithm>
+
+#include "../utils/Console.h"
+
+namespace ActorShadowLimiter {
+
+    void EffectSpellIndex::Build(const ConfigRegistry& registry) {
+        spellsByEffect_.clear();
+
+        size_t spellCount = 0;
+        for (const auto& entry : registry.Entries()) {
+            if (entry.type != ConfigType::SpellLight) continue;
+            ++spellCount;
+
+            auto* spell = entry.form ? entry.form->As<RE::SpellItem>() : nullptr;
+            if (!spell || spell->effects.size() == 0) {
+                DebugPrint("CONFIG", "Warning: Spell FormID 0x%08X not found or has no effects", entry.formId);
+                continue;
+            }
+
+            // Any active effect of the spell marks it as active, not just the light-carrying one
+            for (auto* effect : spell->effects) {
+                if (!effect || !effect->baseEffect) continue;
+
+                auto& spells = spellsByEffect_[effect->baseEffect];
+                if (std::find(spells.begin(), spells.end(), entry.formId) == spells.end()) {
+                    spells.push_back(entry.formId);
+                }
+
+                auto* assocForm = effect->baseEffect->data.associatedForm;
+                if (assocForm && assocForm->As<RE::TESObjectLIGH>()) {
+                    DebugPrint("CONFIG", "Mapped effect 0x%08X -> spell 0x%08X", effect->baseEffect->GetFormID(),
+                               entry.formId);
+                }
+            }
+        }
+
+        DebugPrint("CONFIG", "Built effect-to-spell mapping for %zu configured spells (%zu effects)",
+                   spellCount, spellsByEffect_.size());
+    }
+
+    std::span<const uint32_t> EffectSpellIndex::Find(const RE::EffectSetting* effect) const {
+        auto it = spellsByEffect_.find(effect);
+        if (it == spellsByEffect_.end()) {
+            return {};
+        }
+        return it->second;
+    }
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+#include "Config.h"
+#include "ConfigRegistry.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Reverse index from magic effect to the configured spells that carry it, so active spell
+     * lights can be found by walking an actor's active effects once.
+     */
+    class EffectSpellIndex {
+    public:
+        void Build(const ConfigRegistry& registry);
+
+        std::span<const uint32_t> Find(const RE::EffectSetting* effect) const;  // Spell form IDs
+        size_t Size() const { return spellsByEffect_.size(); }
+
+    private:
+        std::unordered_map<const RE::EffectSetting*, std::vector<uint32_t>> spellsByEffect_;
+    };
+
+    /**
+     * Effect index of the current config snapshot.
+     */
+    const EffectSpellIndex& GetEffectSpellIndex();
+}
@@ -0,0 +1,253 @@
+#include "FormResolver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "../utils/Console.h"
+#include "../utils/Hash.h"
+
+namespace ActorShadowLimiter {
+
+    namespace {
+        constexpr const char* kFormIdCachePath = "Data/SKSE/Plugins/ActorShadows.formids";
+        constexpr std::uint32_t kFormIdCacheMagic = 0x44494641;  // "AFID"
+        constexpr std::uint32_t kFormIdCacheVersion = 2;
+
+        struct FormIdCacheHeader {
+            std::uint32_t magic = kFormIdCacheMagic;
+            std::uint32_t version = kFormIdCacheVersion;
+            std::uint64_t loadOrderHash = 0;
+            std::uint32_t recordCount = 0;
+            std::uint32_t reserved = 0;
+        };
+
+        struct FormIdCacheRecord {
+            std::uint64_t pluginHash = 0;
+            std::uint32_t localFormId = 0;
+            std::uint32_t runtimeFormId = 0;  // Only forms that resolved are stored
+        };
+
+        // (plugin name hash, local form ID) -> runtime form ID
+        using FormIdTable = std::map<std::pair<std::uint64_t, std::uint32_t>, std::uint32_t>;
+
+        struct PendingForm {
+            std::uint32_t* formId;  // Rewritten in place
+            const std::string* plugin;
+            RE::FormType formType;
+            const char* kind;
+        };
+    }
+
+    static std::uint64_t HashPluginName(std::string_view plugin) {
+        // Plugin lookups are case-insensitive, so are the cache keys
+        std::string lower(plugin);
+        std::transform(lower.begin(), lower.end(), lower.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return Fnv1a64(lower);
+    }
+
+    template <class T>
+    static std::uint64_t HashValue(const T& value, std::uint64_t seed) {
+        return Fnv1a64(std::string_view(reinterpret_cast<const char*>(&value), sizeof(value)), seed);
+    }
+
+    /**
+     * Names, compile indices, sizes and timestamps of all loaded plugins, so a plugin edited or
+     * replaced under the same name invalidates the cache as well.
+     */
+    static std::uint64_t HashLoadOrder(RE::TESDataHandler* dataHandler) {
+        std::uint64_t hash = kFnv1aOffsetBasis;
+        for (auto* file : dataHandler->files) {
+            if (!file || file->GetCompileIndex() == 0xFF) continue;
+
+            std::uint32_t indices = (std::uint32_t{file->GetCompileIndex()} << 16) | file->GetSmallFileCompileIndex();
+            hash = Fnv1a64(file->GetFilename(), hash);
+            hash = HashValue(indices, hash);
+
+            // A plugin that cannot be stat'ed hashes as size and time 0, which still keys it by name
+            std::error_code ec;
+            auto path = std::filesystem::path("Data") / file->GetFilename();
+            std::uint64_t size = std::filesystem::file_size(path, ec);
+            if (ec) {
+                size = 0;
+            }
+            auto lastWriteTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+            if (ec) {
+                lastWriteTime = 0;
+            }
+            hash = HashValue(size, hash);
+            hash = HashValue(lastWriteTime, hash);
+        }
+        return hash;
+    }
+
+    // Same type check the templated LookupForm performs
+    static bool IsFormOfType(std::uint32_t formId, RE::FormType formType) {
+        auto* form = RE::TESForm::LookupByID(formId);
+        return form && form->GetFormType() == formType;
+    }
+
+    static FormIdTable ReadFormIdCache(std::uint64_t loadOrderHash) {
+        FormIdTable table;
+
+        std::ifstream in(kFormIdCachePath, std::ios::binary);
+        if (!in.is_open()) {
+            return table;
+        }
+
+        FormIdCacheHeader header;
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || header.magic != kFormIdCacheMagic || header.version != kFormIdCacheVersion ||
+            header.loadOrderHash != loadOrderHash) {
+            return table;
+        }
+
+        std::vector<FormIdCacheRecord> records(header.recordCount);
+        in.read(reinterpret_cast<char*>(records.data()),
+                static_cast<std::streamsize>(records.size() * sizeof(FormIdCacheRecord)));
+        if (!in) {
+            return table;
+        }
+
+        for (const auto& record : records) {
+            if (record.runtimeFormId != 0) {
+                table.emplace(std::make_pair(record.pluginHash, record.localFormId), record.runtimeFormId);
+            }
+        }
+        return table;
+    }
+
+    static void WriteFormIdCache(std::uint64_t loadOrderHash, const FormIdTable& table) {
+        FormIdCacheHeader header;
+        header.loadOrderHash = loadOrderHash;
+        header.recordCount = static_cast<std::uint32_t>(table.size());
+
+        std::vector<FormIdCacheRecord> records;
+        records.reserve(table.size());
+        for (const auto& [key, runtimeFormId] : table) {
+            records.push_back({key.first, key.second, runtimeFormId});
+        }
+
+        // Write next to the target and swap in, so a crash mid-write never leaves a torn cache
+        std::filesystem::path path = kFormIdCachePath;
+        auto tempPath = path;
+        tempPath += ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            if (out.is_open()) {
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.write(reinterpret_cast<const char*>(records.data()),
+                          static_cast<std::streamsize>(records.size() * sizeof(FormIdCacheRecord)));
+            }
+            if (!out) {
+                DebugPrint("CONFIG", "Warning: Could not write form ID cache %s", kFormIdCachePath);
+                return;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            DebugPrint("CONFIG", "Warning: Could not replace form ID cache %s", kFormIdCachePath);
+        }
+    }
+
+    static std::uint32_t ResolveInFile(const RE::TESFile* file, std::uint32_t localFormId, RE::FormType formType) {
+        std::uint32_t formId = 0;
+        if (file->IsLight()) {
+            formId = 0xFE000000 | (std::uint32_t{file->GetSmallFileCompileIndex()} << 12) | (localFormId & 0xFFF);
+        } else if (file->GetCompileIndex() != 0xFF) {
+            formId = (std::uint32_t{file->GetCompileIndex()} << 24) | (localFormId & 0xFFFFFF);
+        } else {
+            return 0;
+        }
+
+        return IsFormOfType(formId, formType) ? formId : 0;
+    }
+
+    void ResolvePluginFormIDs(Config& config) {
+        auto* dataHandler = RE::TESDataHandler::GetSingleton();
+        if (!dataHandler) {
+            DebugPrint("CONFIG", "Warning: Could not get TESDataHandler for plugin resolution");
+            return;
+        }
+
+        std::vector<PendingForm> pending;
+        auto collect = [&pending](auto& entries, RE::FormType formType, const char* kind) {
+            for (auto& entry : entries) {
+                if (!entry.plugin.empty() && entry.formId != 0) {
+                    pending.push_back({&entry.formId, &entry.plugin, formType, kind});
+                }
+            }
+        };
+        collect(config.handHeldLights, RE::FormType::Light, "handHeldLight");
+        collect(config.spells, RE::FormType::Spell, "spell");
+        collect(config.enchantedArmors, RE::FormType::Armor, "enchantedArmor");
+        if (pending.empty()) {
+            return;
+        }
+
+        std::uint64_t loadOrderHash = HashLoadOrder(dataHandler);
+        FormIdTable cached = ReadFormIdCache(loadOrderHash);
+        FormIdTable resolved;
+
+        // Group by plugin so each plugin is looked up once
+        std::stable_sort(pending.begin(), pending.end(),
+                         [](const PendingForm& a, const PendingForm& b) { return *a.plugin < *b.plugin; });
+
+        size_t pluginCount = 0;
+        size_t cacheHits = 0;
+        bool resolvedOutsideCache = false;
+        for (size_t groupStart = 0; groupStart < pending.size();) {
+            const std::string& plugin = *pending[groupStart].plugin;
+            std::uint64_t pluginHash = HashPluginName(plugin);
+            const RE::TESFile* file = nullptr;
+            bool fileLookedUp = false;
+            ++pluginCount;
+
+            size_t i = groupStart;
+            for (; i < pending.size() && *pending[i].plugin == plugin; ++i) {
+                auto& form = pending[i];
+                std::uint32_t localFormId = *form.formId;
+                auto key = std::make_pair(pluginHash, localFormId);
+
+                // A hit is only trusted once the form exists with the expected type
+                std::uint32_t runtimeFormId = 0;
+                if (auto it = cached.find(key); it != cached.end() && IsFormOfType(it->second, form.formType)) {
+                    runtimeFormId = it->second;
+                    ++cacheHits;
+                } else {
+                    if (!fileLookedUp) {
+                        file = dataHandler->LookupModByName(plugin);
+                        fileLookedUp = true;
+                    }
+                    runtimeFormId = file ? ResolveInFile(file, localFormId, form.formType) : 0;
+                    resolvedOutsideCache |= runtimeFormId != 0;
+                }
+
+                // Forms that were not found are looked up again next launch, never cached
+                if (runtimeFormId != 0) {
+                    resolved[key] = runtimeFormId;
+                    *form.formId = runtimeFormId;
+                    DebugPrint("CONFIG", "Resolved %s %s|0x%06X to runtime FormID 0x%08X", form.kind, plugin.c_str(),
+                               localFormId, runtimeFormId);
+                } else {
+                    DebugPrint("CONFIG", "Warning: %s %s|0x%06X not found", form.kind, plugin.c_str(), localFormId);
+                }
+            }
+            groupStart = i;
+        }
+
+        DebugPrint("CONFIG", "Resolved %zu forms across %zu plugins (%zu from load order cache)", pending.size(),
+                   pluginCount, cacheHits);
+
+        if (resolvedOutsideCache || cached.size() != resolved.size()) {
+            WriteFormIdCache(loadOrderHash, resolved);
+        }
+    }
+}
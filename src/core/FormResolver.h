@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Config.h"
+
+namespace ActorShadowLimiter {
+    /**
+     * Rewrites the plugin-relative form IDs of all configured lights, spells and armors to runtime
+     * form IDs in one pass grouped by plugin. Results are cached on disk per load order.
+     */
+    void ResolvePluginFormIDs(Config& config);
+}
@@ -6,6 +6,8 @@ namespace ActorShadowLimiter {
     bool g_isReequipping = false;
     std::atomic<bool> g_pollThreadRunning{false};
     std::atomic<bool> g_shouldPoll{false};
+    std::atomic<bool> g_frameUpdateHookInstalled{false};
+    std::atomic<bool> g_restoredActorsPending{false};
     std::mutex g_lightModificationMutex;
 
 }
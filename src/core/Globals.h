@@ -25,6 +25,8 @@ namespace ActorShadowLimiter {
     extern bool g_isReequipping;
     extern std::atomic<bool> g_pollThreadRunning;
     extern std::atomic<bool> g_shouldPoll;  // Controls whether polling should happen
+    extern std::atomic<bool> g_frameUpdateHookInstalled;
+    extern std::atomic<bool> g_restoredActorsPending;  // Co-save restored actors that await their first update
 
     // Mutex for thread-safe light modifications
     extern std::mutex g_lightModificationMutex;
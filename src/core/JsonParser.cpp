@@ -0,0 +1,390 @@
+#include "JsonParser.h"
+
+#include <array>
+#include <charconv>
+#include <utility>
+#include <vector>
+
+namespace ActorShadowLimiter {
+
+    namespace {
+        enum class LightField : std::uint8_t {
+            Type,
+            FormId,
+            Plugin,
+            RootNodeName,
+            LightNodeName,
+            OffsetX,
+            OffsetY,
+            OffsetZ,
+            RotateX,
+            RotateY,
+            RotateZ,
+            Rule,
+            Keyword,
+            MinRadius
+        };
+
+        constexpr std::array<std::pair<std::string_view, LightField>, 14> kLightFieldKeys{{
+            {"type", LightField::Type},
+            {"formId", LightField::FormId},
+            {"plugin", LightField::Plugin},
+            {"rootNodeName", LightField::RootNodeName},
+            {"lightNodeName", LightField::LightNodeName},
+            {"offsetX", LightField::OffsetX},
+            {"offsetY", LightField::OffsetY},
+            {"offsetZ", LightField::OffsetZ},
+            {"rotateX", LightField::RotateX},
+            {"rotateY", LightField::RotateY},
+            {"rotateZ", LightField::RotateZ},
+            {"rule", LightField::Rule},
+            {"keyword", LightField::Keyword},
+            {"minRadius", LightField::MinRadius},
+        }};
+
+        const LightField* FindLightField(std::string_view key) {
+            for (const auto& [name, field] : kLightFieldKeys) {
+                if (name == key) {
+                    return &field;
+                }
+            }
+            return nullptr;
+        }
+
+        std::string_view Trim(std::string_view value) {
+            while (!value.empty() && (value.front() == ' ' || value.front() == '\t')) value.remove_prefix(1);
+            while (!value.empty() && (value.back() == ' ' || value.back() == '\t')) value.remove_suffix(1);
+            return value;
+        }
+
+        bool ParseFloat(std::string_view value, float& out) {
+            value = Trim(value);
+            if (value.empty()) return false;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out);
+            return ec == std::errc() && ptr == value.data() + value.size();
+        }
+
+        bool ParseBool(std::string_view value, bool& out) {
+            value = Trim(value);
+            if (value == "true") {
+                out = true;
+                return true;
+            }
+            if (value == "false") {
+                out = false;
+                return true;
+            }
+            return false;
+        }
+
+        // Accepts "0x01D4EC" style hex as well as plain decimal form IDs
+        bool ParseFormId(std::string_view value, std::uint32_t& out) {
+            value = Trim(value);
+            int base = 10;
+            if (value.size() > 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X')) {
+                value.remove_prefix(2);
+                base = 16;
+            }
+            if (value.empty()) return false;
+            auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), out, base);
+            return ec == std::errc() && ptr == value.data() + value.size();
+        }
+    }
+
+    void JsonCursor::SkipWhitespace() {
+        while (pos_ < json_.size()) {
+            char c = json_[pos_];
+            if (c != ' ' && c != '\t' && c != '\n' && c != '\r') break;
+            ++pos_;
+        }
+    }
+
+    bool JsonCursor::AtEnd() {
+        SkipWhitespace();
+        return pos_ >= json_.size();
+    }
+
+    bool JsonCursor::Consume(char c) {
+        SkipWhitespace();
+        if (pos_ < json_.size() && json_[pos_] == c) {
+            ++pos_;
+            return true;
+        }
+        return false;
+    }
+
+    char JsonCursor::Peek() {
+        SkipWhitespace();
+        return pos_ < json_.size() ? json_[pos_] : '\0';
+    }
+
+    bool JsonCursor::ReadString(std::string_view& out) {
+        if (!Consume('"')) return false;
+
+        size_t start = pos_;
+        while (pos_ < json_.size()) {
+            char c = json_[pos_];
+            if (c == '\\') {
+                pos_ += 2;
+                continue;
+            }
+            if (c == '"') {
+                out = json_.substr(start, pos_ - start);
+                ++pos_;
+                return true;
+            }
+            ++pos_;
+        }
+        return false;
+    }
+
+    bool JsonCursor::ReadScalar(std::string_view& out) {
+        SkipWhitespace();
+        size_t start = pos_;
+        while (pos_ < json_.size()) {
+            char c = json_[pos_];
+            if (c == ',' || c == '}' || c == ']' || c == ' ' || c == '\t' || c == '\n' || c == '\r') break;
+            ++pos_;
+        }
+        out = json_.substr(start, pos_ - start);
+        return !out.empty();
+    }
+
+    bool JsonCursor::SkipValue() {
+        char c = Peek();
+        if (c == '"') {
+            std::string_view ignored;
+            return ReadString(ignored);
+        }
+        if (c == '{' || c == '[') {
+            // Nested containers are not used by light configs, skip them wholesale
+            int depth = 0;
+            while (pos_ < json_.size()) {
+                char cur = json_[pos_];
+                if (cur == '"') {
+                    std::string_view ignored;
+                    if (!ReadString(ignored)) return false;
+                    continue;
+                }
+                ++pos_;
+                if (cur == '{' || cur == '[') {
+                    ++depth;
+                } else if (cur == '}' || cur == ']') {
+                    if (--depth == 0) return true;
+                }
+            }
+            return false;
+        }
+        std::string_view ignored;
+        return ReadScalar(ignored);
+    }
+
+    namespace {
+        using LightFieldMask = std::uint16_t;
+
+        LightFieldMask FieldBit(LightField field) { return static_cast<LightFieldMask>(1u << static_cast<int>(field)); }
+
+        // Entries of a pack's "lights" array, each with the mask of fields it set itself
+        struct PackLights {
+            std::vector<std::pair<ParsedLightEntry, LightFieldMask>> entries;
+            bool present = false;
+        };
+
+        /**
+         * Parses one object at the cursor. When `pack` is set, a "lights" array is accepted and each
+         * of its objects is parsed into it instead of into `out`.
+         */
+        bool ParseLightObject(JsonCursor& cursor, ParsedLightEntry& out, LightFieldMask& setFields, PackLights* pack,
+                              std::string& error) {
+            if (!cursor.Consume('{')) {
+                error = "expected '{' at offset " + std::to_string(cursor.Position());
+                return false;
+            }
+            if (cursor.Consume('}')) {
+                return true;
+            }
+
+            do {
+                std::string_view key;
+                if (!cursor.ReadString(key) || !cursor.Consume(':')) {
+                    error = "expected key at offset " + std::to_string(cursor.Position());
+                    return false;
+                }
+
+                if (pack && key == "lights") {
+                    pack->present = true;
+                    if (!cursor.Consume('[')) {
+                        error = "expected '[' after 'lights' at offset " + std::to_string(cursor.Position());
+                        return false;
+                    }
+                    if (cursor.Consume(']')) {
+                        continue;
+                    }
+                    do {
+                        auto& [entry, entryFields] = pack->entries.emplace_back();
+                        entryFields = 0;
+                        if (!ParseLightObject(cursor, entry, entryFields, nullptr, error)) {
+                            error = "light " + std::to_string(pack->entries.size() - 1) + ": " + error;
+                            return false;
+                        }
+                    } while (cursor.Consume(','));
+                    if (!cursor.Consume(']')) {
+                        error = "expected ']' at offset " + std::to_string(cursor.Position());
+                        return false;
+                    }
+                    continue;
+                }
+
+                const LightField* field = FindLightField(key);
+                if (!field) {
+                    if (!cursor.SkipValue()) {
+                        error = "malformed value for key '" + std::string(key) + "'";
+                        return false;
+                    }
+                    continue;
+                }
+
+                // Numbers are accepted both bare and quoted, strings only quoted
+                std::string_view value;
+                bool isString = cursor.Peek() == '"';
+                if (isString ? !cursor.ReadString(value) : !cursor.ReadScalar(value)) {
+                    error = "malformed value for key '" + std::string(key) + "'";
+                    return false;
+                }
+
+                bool ok = true;
+                switch (*field) {
+                    case LightField::Type:
+                        out.type = value;
+                        break;
+                    case LightField::FormId:
+                        ok = ParseFormId(value, out.formId);
+                        break;
+                    case LightField::Plugin:
+                        out.plugin = value;
+                        break;
+                    case LightField::RootNodeName:
+                        out.rootNodeName = value;
+                        break;
+                    case LightField::LightNodeName:
+                        out.lightNodeName = value;
+                        break;
+                    case LightField::OffsetX:
+                        ok = ParseFloat(value, out.offsetX);
+                        break;
+                    case LightField::OffsetY:
+                        ok = ParseFloat(value, out.offsetY);
+                        break;
+                    case LightField::OffsetZ:
+                        ok = ParseFloat(value, out.offsetZ);
+                        break;
+                    case LightField::RotateX:
+                        ok = ParseFloat(value, out.rotateX);
+                        break;
+                    case LightField::RotateY:
+                        ok = ParseFloat(value, out.rotateY);
+                        break;
+                    case LightField::RotateZ:
+                        ok = ParseFloat(value, out.rotateZ);
+                        break;
+                    case LightField::Rule:
+                        ok = ParseBool(value, out.isRule);
+                        break;
+                    case LightField::Keyword:
+                        out.keyword = value;
+                        break;
+                    case LightField::MinRadius:
+                        ok = ParseFloat(value, out.minRadius);
+                        break;
+                }
+                if (!ok) {
+                    error = "invalid value '" + std::string(value) + "' for key '" + std::string(key) + "'";
+                    return false;
+                }
+                setFields |= FieldBit(*field);
+            } while (cursor.Consume(','));
+
+            if (!cursor.Consume('}')) {
+                error = "expected '}' at offset " + std::to_string(cursor.Position());
+                return false;
+            }
+            return true;
+        }
+
+        /**
+         * Fills every field the entry did not set itself from the pack-level defaults.
+         */
+        void ApplyPackDefaults(ParsedLightEntry& entry, LightFieldMask setFields, const ParsedLightEntry& defaults) {
+            auto inherit = [setFields](LightField field, auto& value, const auto& fallback) {
+                if (!(setFields & FieldBit(field))) {
+                    value = fallback;
+                }
+            };
+            inherit(LightField::Type, entry.type, defaults.type);
+            inherit(LightField::FormId, entry.formId, defaults.formId);
+            inherit(LightField::Plugin, entry.plugin, defaults.plugin);
+            inherit(LightField::RootNodeName, entry.rootNodeName, defaults.rootNodeName);
+            inherit(LightField::LightNodeName, entry.lightNodeName, defaults.lightNodeName);
+            inherit(LightField::OffsetX, entry.offsetX, defaults.offsetX);
+            inherit(LightField::OffsetY, entry.offsetY, defaults.offsetY);
+            inherit(LightField::OffsetZ, entry.offsetZ, defaults.offsetZ);
+            inherit(LightField::RotateX, entry.rotateX, defaults.rotateX);
+            inherit(LightField::RotateY, entry.rotateY, defaults.rotateY);
+            inherit(LightField::RotateZ, entry.rotateZ, defaults.rotateZ);
+            inherit(LightField::Rule, entry.isRule, defaults.isRule);
+            inherit(LightField::Keyword, entry.keyword, defaults.keyword);
+            inherit(LightField::MinRadius, entry.minRadius, defaults.minRadius);
+        }
+    }
+
+    bool ParseLightEntry(JsonCursor& cursor, ParsedLightEntry& out, std::string& error) {
+        LightFieldMask setFields = 0;
+        return ParseLightObject(cursor, out, setFields, nullptr, error);
+    }
+
+    bool ParseLightConfig(std::string_view json, std::vector<ParsedLightEntry>& out, std::string& error) {
+        JsonCursor cursor(json);
+        out.clear();
+
+        if (cursor.Peek() == '[') {
+            // Bundle: a plain array of entries
+            cursor.Consume('[');
+            if (!cursor.Consume(']')) {
+                do {
+                    if (!ParseLightEntry(cursor, out.emplace_back(), error)) {
+                        error = "light " + std::to_string(out.size() - 1) + ": " + error;
+                        return false;
+                    }
+                } while (cursor.Consume(','));
+                if (!cursor.Consume(']')) {
+                    error = "expected ']' at offset " + std::to_string(cursor.Position());
+                    return false;
+                }
+            }
+        } else {
+            // Single entry, or a pack whose top-level fields are defaults for its "lights"
+            ParsedLightEntry entry;
+            LightFieldMask setFields = 0;
+            PackLights pack;
+            if (!ParseLightObject(cursor, entry, setFields, &pack, error)) {
+                return false;
+            }
+
+            if (pack.present) {
+                out.reserve(pack.entries.size());
+                for (auto& [packEntry, packEntryFields] : pack.entries) {
+                    ApplyPackDefaults(packEntry, packEntryFields, entry);
+                    out.push_back(packEntry);
+                }
+            } else {
+                out.push_back(entry);
+            }
+        }
+
+        if (!cursor.AtEnd()) {
+            error = "unexpected trailing content at offset " + std::to_string(cursor.Position());
+            return false;
+        }
+        return true;
+    }
+}
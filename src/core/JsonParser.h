@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Fields of a single light entry as found in a JSON configuration file.
+     * String fields are views into the source document, which must outlive this struct.
+     */
+    struct ParsedLightEntry {
+        std::string_view type;
+        std::uint32_t formId = 0;
+        std::string_view plugin;
+        std::string_view rootNodeName;
+        std::string_view lightNodeName;
+        float offsetX = 0.0f;
+        float offsetY = 0.0f;
+        float offsetZ = 0.0f;
+        float rotateX = 0.0f;
+        float rotateY = 0.0f;
+        float rotateZ = 0.0f;
+
+        // Rule entries match every loaded form of their type that passes the filters below
+        bool isRule = false;
+        std::string_view keyword;
+        float minRadius = 0.0f;
+    };
+
+    /**
+     * Minimal forward-only JSON reader over a string_view. Does not allocate and does not
+     * unescape strings, which light configs never need.
+     */
+    class JsonCursor {
+    public:
+        explicit JsonCursor(std::string_view json) : json_(json) {}
+
+        void SkipWhitespace();
+        bool AtEnd();
+        bool Consume(char c);
+        char Peek();
+
+        bool ReadString(std::string_view& out);
+        bool ReadScalar(std::string_view& out);
+        bool SkipValue();
+
+        std::size_t Position() const { return pos_; }
+
+    private:
+        std::string_view json_;
+        std::size_t pos_ = 0;
+    };
+
+    /**
+     * Parses one light entry object at the cursor in a single pass. Unknown keys are skipped.
+     * Returns false and sets `error` if the object is malformed.
+     */
+    bool ParseLightEntry(JsonCursor& cursor, ParsedLightEntry& out, std::string& error);
+
+    /**
+     * Parses a whole light configuration document in one pass. Accepts a single entry object, an
+     * array of entry objects, or a pack object whose "lights" array holds the entries and whose
+     * other fields (typically "plugin") are defaults for every entry.
+     */
+    bool ParseLightConfig(std::string_view json, std::vector<ParsedLightEntry>& out, std::string& error);
+}
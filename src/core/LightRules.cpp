@@ -0,0 +1,140 @@
+#include "LightRules.h"
+
+#include "../utils/Console.h"
+#include "../utils/Light.h"
+
+namespace ActorShadowLimiter {
+
+    namespace {
+        struct CompiledRule {
+            const LightMatchRule* match = nullptr;
+            const void* config = nullptr;
+            const RE::TESFile* file = nullptr;  // Set when the rule is limited to one plugin
+            RE::BGSKeyword* keyword = nullptr;  // Set when the rule requires a keyword
+            size_t matchCount = 0;
+        };
+
+        /**
+         * Resolves the plugin and keyword names of each rule once, dropping rules whose plugin is
+         * not loaded, whose keyword does not exist, or that filter by keyword on forms without any.
+         */
+        template <class T>
+        std::vector<CompiledRule> CompileRules(RE::TESDataHandler* dataHandler, const std::vector<RuleConfig<T>>& rules,
+                                               const char* kind, bool formsHaveKeywords) {
+            std::vector<CompiledRule> compiled;
+            compiled.reserve(rules.size());
+            for (const auto& rule : rules) {
+                CompiledRule entry{&rule.match, &rule.config};
+                if (!rule.match.plugin.empty()) {
+                    entry.file = dataHandler->LookupModByName(rule.match.plugin);
+                    if (!entry.file) {
+                        DebugPrint("CONFIG", "Warning: %s rule plugin %s is not loaded, skipping", kind,
+                                   rule.match.plugin.c_str());
+                        continue;
+                    }
+                }
+                if (!rule.match.keyword.empty()) {
+                    if (!formsHaveKeywords) {
+                        DebugPrint("CONFIG", "Warning: %s rule keyword %s cannot match keywordless forms, skipping",
+                                   kind, rule.match.keyword.c_str());
+                        continue;
+                    }
+                    entry.keyword = RE::TESForm::LookupByEditorID<RE::BGSKeyword>(rule.match.keyword);
+                    if (!entry.keyword) {
+                        DebugPrint("CONFIG", "Warning: %s rule keyword %s not found, skipping", kind,
+                                   rule.match.keyword.c_str());
+                        continue;
+                    }
+                }
+                compiled.push_back(entry);
+            }
+            return compiled;
+        }
+
+        bool SpellHasKeyword(RE::SpellItem* spell, RE::BGSKeyword* keyword) {
+            if (spell->HasKeyword(keyword)) {
+                return true;
+            }
+            // Light spells usually carry their keywords on the magic effect, not the spell
+            for (auto* effect : spell->effects) {
+                if (effect && effect->baseEffect && effect->baseEffect->HasKeyword(keyword)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /**
+         * Walks one form table, testing each form that spawns a light against the compiled rules.
+         * `resolve` returns the light a form spawns, `hasKeyword` tests a rule keyword on it.
+         */
+        template <class FormT, class ResolveLight, class HasKeyword>
+        void MatchForms(RE::TESDataHandler* dataHandler, std::vector<CompiledRule>& rules, ConfigType type,
+                        ResolveLight&& resolve, HasKeyword&& hasKeyword, std::vector<ConfigLookup>& matches) {
+            if (rules.empty()) {
+                return;
+            }
+
+            for (auto* form : dataHandler->GetFormArray<FormT>()) {
+                if (!form) continue;
+
+                RE::TESObjectLIGH* light = resolve(form);
+                if (!light) continue;
+
+                const RE::TESFile* file = form->GetFile(0);
+                for (auto& rule : rules) {
+                    if (rule.file && rule.file != file) continue;
+                    if (static_cast<float>(light->data.radius) < rule.match->minRadius) continue;
+                    if (rule.keyword && !hasKeyword(form, rule.keyword)) continue;
+
+                    matches.push_back({form->GetFormID(), type, rule.config, form, light});
+                    ++rule.matchCount;
+                    break;
+                }
+            }
+        }
+
+        void LogMatches(const std::vector<CompiledRule>& rules, const char* kind) {
+            for (const auto& rule : rules) {
+                DebugPrint("CONFIG", "%s rule [plugin=%s keyword=%s minRadius=%.0f] matched %zu forms", kind,
+                           rule.match->plugin.empty() ? "*" : rule.match->plugin.c_str(),
+                           rule.match->keyword.empty() ? "*" : rule.match->keyword.c_str(), rule.match->minRadius,
+                           rule.matchCount);
+            }
+        }
+    }
+
+    void CollectRuleMatches(const Config& config, std::vector<ConfigLookup>& matches) {
+        if (config.handHeldLightRules.empty() && config.spellRules.empty() && config.enchantedArmorRules.empty()) {
+            return;
+        }
+
+        auto* dataHandler = RE::TESDataHandler::GetSingleton();
+        if (!dataHandler) {
+            DebugPrint("CONFIG", "Warning: Could not get TESDataHandler for rule matching");
+            return;
+        }
+
+        // LIGH records have no keywords, keyword rules for them are rejected here
+        auto lightRules = CompileRules(dataHandler, config.handHeldLightRules, "HandheldLight", false);
+        auto spellRules = CompileRules(dataHandler, config.spellRules, "SpellLight", true);
+        auto armorRules = CompileRules(dataHandler, config.enchantedArmorRules, "EnchantmentLight", true);
+
+        // Only lights that can be carried are hand-held
+        MatchForms<RE::TESObjectLIGH>(
+            dataHandler, lightRules, ConfigType::HandheldLight,
+            [](RE::TESObjectLIGH* light) { return light->CanBeCarried() ? light : nullptr; },
+            [](RE::TESObjectLIGH*, RE::BGSKeyword*) { return false; }, matches);
+        MatchForms<RE::SpellItem>(
+            dataHandler, spellRules, ConfigType::SpellLight,
+            [](RE::SpellItem* spell) { return GetAssociatedLight(spell); }, SpellHasKeyword, matches);
+        MatchForms<RE::TESObjectARMO>(
+            dataHandler, armorRules, ConfigType::EnchantmentLight,
+            [](RE::TESObjectARMO* armor) { return GetAssociatedLight(armor->formEnchanting); },
+            [](RE::TESObjectARMO* armor, RE::BGSKeyword* keyword) { return armor->HasKeyword(keyword); }, matches);
+
+        LogMatches(lightRules, "HandheldLight");
+        LogMatches(spellRules, "SpellLight");
+        LogMatches(armorRules, "EnchantmentLight");
+    }
+}
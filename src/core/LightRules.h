@@ -0,0 +1,16 @@
+#pragma once
+
+#include <vector>
+
+#include "Config.h"
+#include "ConfigRegistry.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Evaluates the config's rule entries against the loaded form tables and appends one resolved
+     * lookup per matching form, first matching rule winning. Runs once per config snapshot so
+     * listeners only ever do a registry lookup, never a predicate.
+     */
+    void CollectRuleMatches(const Config& config, std::vector<ConfigLookup>& matches);
+}
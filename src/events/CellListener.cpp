@@ -6,6 +6,7 @@
 #include "../core/Config.h"
 #include "../core/Globals.h"
 #include "../utils/Console.h"
+#include "../utils/TaskScheduler.h"
 
 namespace ActorShadowLimiter {
     CellListener* CellListener::GetSingleton() {
@@ -21,6 +22,16 @@ namespace ActorShadowLimiter {
         }
     }
 
+    // Saved shadow states are applied now rather than one poll interval later
+    static void ReconcileRestoredActors() {
+        if (!g_restoredActorsPending.exchange(false)) {
+            return;
+        }
+        DebugPrint("CELL_LOAD", "Reconciling %zu actors restored from save",
+                   ActorTracker::GetSingleton().GetTrackedActorCount());
+        UpdateTrackedLights();
+    }
+
     RE::BSEventNotifyControl CellListener::ProcessEvent(const RE::TESCellFullyLoadedEvent* event,
                                                         RE::BSTEventSource<RE::TESCellFullyLoadedEvent>*) {
         // Sanity checks
@@ -32,52 +43,62 @@ namespace ActorShadowLimiter {
             return RE::BSEventNotifyControl::kContinue;
         }
 
-        // If polling is active - Skip and instead rely on its logic instead
+        // A freshly loaded cell brings its own lights, never evaluate it against the old scan
+        InvalidateSceneSnapshot();
+
+        // If polling is active - Skip and instead rely on its logic instead, apart from a save that was just loaded
         // If not, we can assume that the game is fresh or no actor has active configured lights
+        using namespace std::chrono_literals;
         if (g_pollThreadRunning) {
+            if (g_restoredActorsPending) {
+                TaskScheduler::GetSingleton().Schedule(2000ms, []() { ReconcileRestoredActors(); });
+            }
             return RE::BSEventNotifyControl::kContinue;
         }
 
         // Delay cell load processing by 2 seconds
-        std::thread([]() {
-            using namespace std::chrono_literals;
-            std::this_thread::sleep_for(2000ms);
+        TaskScheduler::GetSingleton().Schedule(2000ms, []() {
+            auto* player = RE::PlayerCharacter::GetSingleton();
+            if (!player) {
+                return;
+            }
 
-            if (auto* tasks = SKSE::GetTaskInterface()) {
-                tasks->AddTask([]() {
-                    auto* player = RE::PlayerCharacter::GetSingleton();
-                    if (!player) {
-                        return;
-                    }
+            // Check if player have equipped configured lights, newly loaded NPCs often do not
+            auto activeLight = GetActiveConfiguredLight(player);
+            auto activeSpells = GetActiveConfiguredSpells(player);
+            auto activeEnchantments = GetActiveConfiguredEnchantedArmors(player);
 
-                    // Check if player have equipped configured lights, newly loaded NPCs often do not
-                    auto activeLight = GetActiveConfiguredLight(player);
-                    auto activeSpells = GetActiveConfiguredSpells(player);
-                    auto activeEnchantments = GetActiveConfiguredEnchantedArmors(player);
+            // Actors restored from the co-save need tracking even if the player carries nothing
+            bool hasRestoredActors = ActorTracker::GetSingleton().GetTrackedActorCount() > 0;
+            bool playerHasLight = activeLight.has_value() || !activeSpells.empty() || !activeEnchantments.empty();
+            if (!playerHasLight && !hasRestoredActors) {
+                DebugPrint("CELL_LOAD", "Cell fully loaded. Player has no active configured light. Skipping tracking.");
+                return;
+            }
 
-                    if (!activeLight.has_value() && activeSpells.empty() && activeEnchantments.empty()) {
-                        DebugPrint("CELL_LOAD",
-                                   "Cell fully loaded. Player has no active configured light. Skipping tracking.");
-                        return;
-                    }
+            // Add tracking to the player and rely on polling
+            if (playerHasLight) {
+                auto* trackedActor = ActorTracker::GetSingleton().GetOrCreateActor(player->GetFormID());
+                if (!trackedActor) {
+                    return;
+                }
+                for (uint32_t enchantedArmorFormId : activeEnchantments) {
+                    trackedActor->TrackLight(enchantedArmorFormId);
+                }
+                if (activeLight.has_value()) {
+                    trackedActor->TrackLight(activeLight.value());
+                }
+                for (uint32_t spellFormId : activeSpells) {
+                    trackedActor->TrackLight(spellFormId);
+                }
+            }
 
-                    // Add tracking to the player and rely on polling
-                    auto* trackedActor = ActorTracker::GetSingleton().GetOrCreateActor(player->GetFormID());
-                    if (!activeEnchantments.empty() && activeEnchantments.size() > 0) {
-                        trackedActor->SetTrackedLight(activeEnchantments[0]);
-                    } else if (activeLight.has_value()) {
-                        trackedActor->SetTrackedLight(activeLight.value());
-                    } else if (!activeSpells.empty() && activeSpells.size() > 0) {
-                        trackedActor->SetTrackedLight(activeSpells[0]);
-                    }
+            ReconcileRestoredActors();
 
-                    EnablePolling(0);
+            EnablePolling(0);
 
-                    DebugPrint("CELL_LOAD",
-                               "Cell fully loaded. Player has active configured light(s). Starting tracking.");
-                });
-            }
-        }).detach();
+            DebugPrint("CELL_LOAD", "Cell fully loaded. Player has active configured light(s). Starting tracking.");
+        });
 
         return RE::BSEventNotifyControl::kContinue;
     }
@@ -56,21 +56,15 @@ namespace ActorShadowLimiter {
         // If a re-equip is in action, shadow or static - Skip execution
         // We are assuming that actor is being tracked, otherwise skip execution
         auto* trackedActor = ActorTracker::GetSingleton().GetActor(actor->GetFormID());
-        if (trackedActor && trackedActor->IsReEquipping()) {
+        if (trackedActor && trackedActor->IsReEquipping(form->GetFormID())) {
             DebugPrint("EQUIP", actor, "Re-equip in progress for light 0x%08X.", form->GetFormID());
             return RE::BSEventNotifyControl::kContinue;
         }
 
-        // Actor unequipped the light, and not during a re-equip -> Stop tracking the actor
+        // Actor unequipped the light, and not during a re-equip -> Stop tracking the light, and the actor with its last one
         if (!event->equipped) {
             DebugPrint("EQUIP", actor, "Unequipped light 0x%08X. Stopping tracking.", form->GetFormID());
-            ActorTracker::GetSingleton().RemoveActor(actor->GetFormID());
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        // Handle case where multiple configured lights are equipped
-        if (trackedActor->HasTrackedLight() && trackedActor->GetTrackedLight() != form->GetFormID()) {
-            DebugPrint("WARN", actor, "Already tracking light 0x%08X.", trackedActor->GetTrackedLight().value_or(0));
+            ActorTracker::GetSingleton().RemoveActorLight(actor->GetFormID(), form->GetFormID());
             return RE::BSEventNotifyControl::kContinue;
         }
 
@@ -82,6 +76,13 @@ namespace ActorShadowLimiter {
             return RE::BSEventNotifyControl::kContinue;
         }
 
+        // Each light is tracked on its own, only a full set of light slots turns one away
+        if (!trackedActor->CanTrackLight(form->GetFormID())) {
+            DebugPrint("WARN", actor, "Already tracking %zu lights, ignoring light 0x%08X.",
+                       TrackedActor::kMaxTrackedLights, form->GetFormID());
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
         // Handle different kinds of equipped lights
         bool isShadowsAllowed = EvaluateActorAndScene(actor);
         if (IsHandheldLight(form)) {
@@ -0,0 +1,24 @@
+#include "FrameUpdateHook.h"
+
+#include "../UpdateLogic.h"
+#include "../core/Config.h"
+#include "../core/Globals.h"
+#include "../utils/Console.h"
+
+namespace ActorShadowLimiter {
+    void FrameUpdateHook::Install() {
+        // Actor::Update runs once per frame for the player on the main thread, and not while paused
+        REL::Relocation<std::uintptr_t> vtable{RE::VTABLE_PlayerCharacter[0]};
+        _Update = vtable.write_vfunc(0xAD, Update);
+        g_frameUpdateHookInstalled = true;
+        DebugPrint("INIT", "FrameUpdateHook installed.");
+    }
+
+    void FrameUpdateHook::Update(RE::PlayerCharacter* player, float delta) {
+        _Update(player, delta);
+
+        if (GetConfig().enableFrameUpdate) {
+            RunFrameUpdate();
+        }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include "SKSE/SKSE.h"
+
+namespace ActorShadowLimiter {
+
+    class FrameUpdateHook {
+    public:
+        static void Install();
+
+    private:
+        static void Update(RE::PlayerCharacter* player, float delta);
+
+        static inline REL::Relocation<decltype(Update)> _Update;
+    };
+
+}
@@ -16,8 +16,6 @@ namespace ActorShadowLimiter {
     }
 
     void SpellCastListener::Install() {
-        BuildEffectToSpellMapping();
-
         auto* eventSource = RE::ScriptEventSourceHolder::GetSingleton();
         if (eventSource) {
             eventSource->AddEventSink<RE::TESSpellCastEvent>(GetSingleton());
@@ -45,19 +43,20 @@ namespace ActorShadowLimiter {
 
         auto* trackedActor = ActorTracker::GetSingleton().GetOrCreateActor(actor->GetFormID());
 
-        // Handle case where multiple configured lights are equipped
-        if (trackedActor->HasTrackedLight() && trackedActor->GetTrackedLight() != spell->GetFormID()) {
-            DebugPrint("WARN", actor, "Already tracking light 0x%08X.", trackedActor->GetTrackedLight().value_or(0));
-            return RE::BSEventNotifyControl::kContinue;
-        }
-
-        // Safety check - actor should exist since we created it on equip
+        // Safety check - actor should exist since we created it on cast
         if (!trackedActor) {
             DebugPrint("WARN", actor, "Untracked actor detected! Failed to track actor after spell light 0x%08X.",
                        spell->GetFormID());
             return RE::BSEventNotifyControl::kContinue;
         }
 
+        // Each light is tracked on its own, only a full set of light slots turns one away
+        if (!trackedActor->CanTrackLight(spell->GetFormID())) {
+            DebugPrint("WARN", actor, "Already tracking %zu lights, ignoring spell light 0x%08X.",
+                       TrackedActor::kMaxTrackedLights, spell->GetFormID());
+            return RE::BSEventNotifyControl::kContinue;
+        }
+
         bool isShadowsAllowed = EvaluateActorAndScene(actor);
         if (isShadowsAllowed) {
             ForceCastSpell(actor, spell, true);
@@ -1,12 +1,17 @@
 #include "SKSE/SKSE.h"
 #include "UpdateLogic.h"
+#include "actor/ActorTracker.h"
+#include "actor/TrackerSerialization.h"
 #include "core/Config.h"
+#include "core/ConfigStore.h"
 #include "core/Globals.h"
 #include "events/CellListener.h"
 #include "events/EquipListener.h"
+#include "events/FrameUpdateHook.h"
 #include "events/SpellCastListener.h"
 #include "utils/Console.h"
 #include "utils/Helpers.h"
+#include "utils/ShadowDistanceKernel.h"
 
 using namespace SKSE;
 using namespace ActorShadowLimiter;
@@ -14,15 +19,23 @@ using namespace ActorShadowLimiter;
 SKSEPluginLoad(const SKSE::LoadInterface* skse) {
     InitializeLog();
     SKSE::Init(skse);
+    ActorTracker::GetSingleton().BindToMainThread();
     SKSE::log::info("ActorShadows loaded");
+    SKSE::log::info("Shadow distance kernel: {}", GetShadowDistanceKernelName());
+
+    InstallTrackerSerialization();
 
     SKSE::GetMessagingInterface()->RegisterListener([](SKSE::MessagingInterface::Message* message) {
         if (message->type == SKSE::MessagingInterface::kDataLoaded) {
-            LoadConfig();
+            ReloadConfig();
 
             EquipListener::Install();
             SpellCastListener::Install();
             CellListener::Install();
+            if (GetConfig().enableFrameUpdate) {
+                FrameUpdateHook::Install();
+            }
+            StartConfigWatcher();
 
             WarnIfLightsHaveShadows();
         }
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace ActorShadowLimiter {
+
+    // Three cell coordinates in one key, 21 bits per axis covers any worldspace at practical cell sizes
+    inline uint64_t PackCellKey(int32_t x, int32_t y, int32_t z) {
+        constexpr uint64_t kMask = (1ull << 21) - 1;
+        return ((static_cast<uint64_t>(x) & kMask) << 42) | ((static_cast<uint64_t>(y) & kMask) << 21) |
+               (static_cast<uint64_t>(z) & kMask);
+    }
+
+    /**
+     * Open-addressing table from packed cell keys to one small value, linear probing at or below half
+     * load. A slot holding `kEmpty` is free, so stored values never equal it. Clear() keeps the capacity,
+     * so a table reused every scan stops allocating once it has grown to the scene.
+     */
+    template <class Value, Value kEmpty>
+    class CellTable {
+    public:
+        // Empties the table, sized so `expected` entries fit without growing
+        void Clear(size_t expected = 0) {
+            size_t capacity = std::max<size_t>(slots_.size(), kMinCapacity);
+            while (capacity < expected * 2) {
+                capacity <<= 1;
+            }
+            slots_.resize(capacity);
+            std::fill(slots_.begin(), slots_.end(), Slot{});
+            used_ = 0;
+        }
+
+        size_t Size() const { return used_; }
+
+        // Value stored for `key`, or kEmpty
+        Value Find(uint64_t key) const { return slots_.empty() ? kEmpty : slots_[Probe(key)].value; }
+
+        // Value stored for `key` to modify in place, or null
+        Value* Lookup(uint64_t key) {
+            if (slots_.empty()) return nullptr;
+            auto& slot = slots_[Probe(key)];
+            return slot.value != kEmpty ? &slot.value : nullptr;
+        }
+
+        // Value of `key`, a new entry reads kEmpty and must be assigned before the table is used again
+        Value& Insert(uint64_t key) {
+            if ((used_ + 1) * 2 > slots_.size()) {
+                Grow();
+            }
+            auto& slot = slots_[Probe(key)];
+            if (slot.value == kEmpty) {
+                slot.key = key;
+                ++used_;
+            }
+            return slot.value;
+        }
+
+        // Drops `key`, which must be present, even if its value was already set back to kEmpty
+        void Erase(uint64_t key) {
+            size_t mask = slots_.size() - 1;
+            size_t gap = Probe(key);
+            for (size_t next = (gap + 1) & mask; slots_[next].value != kEmpty; next = (next + 1) & mask) {
+                // Later entries of the probe run move back unless their home slot lies between the gap and them
+                size_t home = HomeSlot(slots_[next].key);
+                if (((next - home) & mask) >= ((next - gap) & mask)) {
+                    slots_[gap] = slots_[next];
+                    gap = next;
+                }
+            }
+            slots_[gap] = Slot{};
+            --used_;
+        }
+
+    private:
+        static constexpr size_t kMinCapacity = 64;
+
+        struct Slot {
+            uint64_t key = 0;
+            Value value = kEmpty;
+        };
+
+        size_t HomeSlot(uint64_t key) const {
+            return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & (slots_.size() - 1);
+        }
+
+        // Slot holding `key`, or the free slot where it would go
+        size_t Probe(uint64_t key) const {
+            size_t mask = slots_.size() - 1;
+            size_t i = HomeSlot(key);
+            while (slots_[i].value != kEmpty && slots_[i].key != key) {
+                i = (i + 1) & mask;
+            }
+            return i;
+        }
+
+        void Grow() {
+            std::vector<Slot> old(std::max<size_t>(slots_.size() * 2, kMinCapacity));
+            old.swap(slots_);
+            for (const auto& slot : old) {
+                if (slot.value != kEmpty) {
+                    slots_[Probe(slot.key)] = slot;
+                }
+            }
+        }
+
+        std::vector<Slot> slots_;
+        size_t used_ = 0;
+    };
+}
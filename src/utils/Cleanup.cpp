@@ -1,13 +1,15 @@
 #include "Cleanup.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cmath>
 #include <thread>
-#include <unordered_map>
 #include <vector>
 
 #include "../actor/ActorTracker.h"
 #include "../core/Config.h"
+#include "../core/ConfigStore.h"
+#include "../utils/CellTable.h"
 #include "../utils/Console.h"
 #include "SKSE/SKSE.h"
 
@@ -16,22 +18,10 @@ namespace ActorShadowLimiter {
     static std::atomic<bool> g_duplicateRemovalThreadRunning{false};
 
     // Check if any tracked actors have shadows enabled
-    static bool HasActorsWithShadows() {
-        auto trackedActorIds = ActorTracker::GetSingleton().GetAllTrackedActorIds();
-        for (uint32_t actorFormId : trackedActorIds) {
-            auto* trackedActor = ActorTracker::GetSingleton().GetActor(actorFormId);
-            if (trackedActor && trackedActor->HasTrackedLight()) {
-                auto trackedLight = trackedActor->GetTrackedLight();
-                if (trackedLight.has_value() && trackedActor->GetLightShadowState(trackedLight.value())) {
-                    return true;
-                }
-            }
-        }
-        return false;
-    }
+    static bool HasActorsWithShadows() { return ActorTracker::GetSingleton().GetTrackedActorsWithShadowsCount() > 0; }
 
     void StartDuplicateRemovalThread() {
-        if (!g_config.enableDuplicateFix) return;
+        if (!GetConfig().enableDuplicateFix) return;
 
         bool expected = false;
         if (!g_duplicateRemovalThreadRunning.compare_exchange_strong(expected, true)) {
@@ -41,10 +31,11 @@ namespace ActorShadowLimiter {
         std::thread([]() {
             using namespace std::chrono_literals;
             DebugPrint("DUPLICATE", "Duplicate removal thread started (%dms interval)",
-                       g_config.duplicateRemovalIntervalMs);
+                       AcquireConfigSnapshot()->config.duplicateRemovalIntervalMs);
 
             while (g_duplicateRemovalThreadRunning) {
-                std::this_thread::sleep_for(std::chrono::milliseconds(g_config.duplicateRemovalIntervalMs));
+                auto interval = AcquireConfigSnapshot()->config.duplicateRemovalIntervalMs;
+                std::this_thread::sleep_for(std::chrono::milliseconds(interval));
 
                 if (!g_duplicateRemovalThreadRunning) {
                     break;
@@ -53,7 +44,7 @@ namespace ActorShadowLimiter {
                 // Auto-stop if no tracked actors have shadows enabled
                 if (!HasActorsWithShadows()) {
                     DebugPrint("DUPLICATE", "No tracked actors with shadows, stopping thread");
-                    StopDuplicateRemovalThread();
+                    g_duplicateRemovalThreadRunning = false;
                     break;
                 }
 
@@ -66,7 +57,7 @@ namespace ActorShadowLimiter {
     }
 
     void StopDuplicateRemovalThread() {
-        if (!g_config.enableDuplicateFix) return;
+        if (!GetConfig().enableDuplicateFix) return;
 
         if (g_duplicateRemovalThreadRunning) {
             DebugPrint("DUPLICATE", "Stopping duplicate removal thread");
@@ -74,8 +65,14 @@ namespace ActorShadowLimiter {
         }
     }
 
+    // Light positions rounded to whole units
+    static uint64_t QuantizedPositionKey(const RE::NiPoint3& pos) {
+        auto axis = [](float value) { return static_cast<int32_t>(std::lround(value)); };
+        return PackCellKey(axis(pos.x), axis(pos.y), axis(pos.z));
+    }
+
     void HideDuplicateLights() {
-        if (!g_config.enableDuplicateFix) return;
+        if (!GetConfig().enableDuplicateFix) return;
 
         // Get the shadow scene node
         auto* smState = &RE::BSShaderManager::State::GetSingleton();
@@ -84,61 +81,49 @@ namespace ActorShadowLimiter {
         auto* shadowSceneNode = smState->shadowSceneNode[0];
         if (!shadowSceneNode) return;
 
-        // Map: position key (rounded xyz) -> list of (bsLight, niLight, isShadowLight)
-        std::unordered_map<std::string, std::vector<std::tuple<RE::BSLight*, RE::NiLight*, bool>>> lightsByPosition;
-
-        auto scanLights = [&](const auto& lightList, bool isShadowList) {
-            for (const auto& lightPtr : lightList) {
-                if (auto* bsLight = lightPtr.get()) {
-                    if (auto* niLight = bsLight->light.get()) {
-                        // Get light world position
-                        RE::NiPoint3 pos = niLight->world.translate;
+        auto& activeLights = shadowSceneNode->GetRuntimeData().activeLights;
+        auto& activeShadowLights = shadowSceneNode->GetRuntimeData().activeShadowLights;
 
-                        // Create position key (round to nearest unit to handle floating point precision)
-                        std::string posKey = std::to_string(static_cast<int>(std::round(pos.x))) + "_" +
-                                             std::to_string(static_cast<int>(std::round(pos.y))) + "_" +
-                                             std::to_string(static_cast<int>(std::round(pos.z)));
-
-                        lightsByPosition[posKey].emplace_back(bsLight, niLight, isShadowList);
-                    }
-                }
-            }
+        auto lightKey = [](const RE::NiPointer<RE::BSLight>& lightPtr, uint64_t& key) {
+            auto* bsLight = lightPtr.get();
+            auto* niLight = bsLight ? bsLight->light.get() : nullptr;
+            if (!niLight) return false;
+            key = QuantizedPositionKey(niLight->world.translate);
+            return true;
         };
 
-        // Scan both shadow and non-shadow lights
-        scanLights(shadowSceneNode->GetRuntimeData().activeLights, false);
-        scanLights(shadowSceneNode->GetRuntimeData().activeShadowLights, true);
-
-        // Remove duplicate BSLight entries from scene lists
-        int duplicatesRemoved = 0;
-        for (auto& [posKey, lights] : lightsByPosition) {
-            if (lights.size() > 1) {
-                DebugPrint("DUPLICATE", "Found %zu lights at position %s", lights.size(), posKey.c_str());
-                // Keep shadow-casting lights, remove non-shadow duplicates
-                for (size_t i = 0; i < lights.size(); ++i) {
-                    auto& [bsLight, niLight, isShadowLight] = lights[i];
-
-                    // Only remove non-shadow-casting duplicates
-                    if (isShadowLight) {
-                        continue;
-                    }
-
-                    // Remove non-shadow duplicate from activeLights array
-                    auto& lightList = shadowSceneNode->GetRuntimeData().activeLights;
-                    auto it = std::find_if(lightList.begin(), lightList.end(),
-                                           [bsLight](const auto& ptr) { return ptr.get() == bsLight; });
-                    if (it != lightList.end()) {
-                        DebugPrint("DUPLICATE", "Removing non-shadow BSLight 0x%p at position %s", bsLight,
-                                   posKey.c_str());
-                        lightList.erase(it);
-                        duplicatesRemoved++;
-                    }
+        // Lights per quantized position. Runs as a main thread task only, the table is reused across runs
+        static CellTable<uint32_t, 0> lightsByPosition;
+        lightsByPosition.Clear(activeLights.size() + activeShadowLights.size());
+
+        // Count shadow and non-shadow lights at every position
+        for (const auto* lightList : {&activeLights, &activeShadowLights}) {
+            for (const auto& lightPtr : *lightList) {
+                uint64_t key;
+                if (lightKey(lightPtr, key)) {
+                    ++lightsByPosition.Insert(key);
                 }
             }
         }
 
+        // Non-shadow lights sharing a position with any other light are duplicates, drop them in one pass
+        auto newEnd = std::remove_if(activeLights.begin(), activeLights.end(), [&](const auto& lightPtr) {
+            uint64_t key;
+            if (!lightKey(lightPtr, key)) return false;
+
+            uint32_t count = lightsByPosition.Find(key);
+            if (count <= 1) return false;
+
+            const auto& pos = lightPtr->light->world.translate;
+            DebugPrint("DUPLICATE", "Removing non-shadow BSLight 0x%p at (%.0f, %.0f, %.0f), %u lights share it",
+                       lightPtr.get(), pos.x, pos.y, pos.z, count);
+            return true;
+        });
+
+        auto duplicatesRemoved = static_cast<size_t>(std::distance(newEnd, activeLights.end()));
         if (duplicatesRemoved > 0) {
-            DebugPrint("DUPLICATE", "Removed %d duplicate light(s) from scene", duplicatesRemoved);
+            activeLights.resize(activeLights.size() - duplicatesRemoved);
+            DebugPrint("DUPLICATE", "Removed %zu duplicate light(s) from scene", duplicatesRemoved);
         }
     }
 
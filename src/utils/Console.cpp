@@ -1,10 +1,12 @@
 #include "Console.h"
 
+#include <atomic>
 #include <sstream>
 
-#include "../core/Config.h"
-
 namespace ActorShadowLimiter {
+    // Mirrors EnableDebug, set as soon as the INI is read so the rest of the config load can log
+    static std::atomic<bool> g_debugEnabled{false};
+
     void InitializeLog() {
         auto path = SKSE::log::log_directory();
         if (!path) {
@@ -22,8 +24,10 @@ namespace ActorShadowLimiter {
         spdlog::set_pattern("%g(%#): [%l] %v"s);
     }
 
+    void SetDebugEnabled(bool enabled) { g_debugEnabled = enabled; }
+
     void DebugPrint(const std::string& action, const char* format, ...) {
-        if (!g_config.enableDebug) return;
+        if (!g_debugEnabled) return;
 
         char buffer[1024];
         va_list args;
@@ -35,7 +39,7 @@ namespace ActorShadowLimiter {
     }
 
     void DebugPrint(const std::string& action, RE::Actor* actor, const char* format, ...) {
-        if (!g_config.enableDebug) return;
+        if (!g_debugEnabled) return;
 
         char buffer[1024];
         va_list args;
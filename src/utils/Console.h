@@ -4,6 +4,7 @@
 
 namespace ActorShadowLimiter {
     void InitializeLog();
+    void SetDebugEnabled(bool enabled);
     void DebugPrint(const std::string& action, const char* format, ...);
     void DebugPrint(const std::string& action, RE::Actor* actor, const char* format, ...);
     void PrintPlayerNiNodeTree();
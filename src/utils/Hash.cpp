@@ -0,0 +1,16 @@
+#include "Hash.h"
+
+namespace ActorShadowLimiter {
+
+    std::uint64_t Fnv1a64(std::string_view data, std::uint64_t seed) {
+        constexpr std::uint64_t prime = 1099511628211ull;
+
+        std::uint64_t hash = seed;
+        for (char c : data) {
+            hash ^= static_cast<std::uint8_t>(c);
+            hash *= prime;
+        }
+        return hash;
+    }
+
+}
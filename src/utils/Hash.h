@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace ActorShadowLimiter {
+    inline constexpr std::uint64_t kFnv1aOffsetBasis = 14695981039346656037ull;
+
+    /**
+     * 64-bit FNV-1a. Pass a previous result as `seed` to hash several pieces as one stream.
+     */
+    std::uint64_t Fnv1a64(std::string_view data, std::uint64_t seed = kFnv1aOffsetBasis);
+}
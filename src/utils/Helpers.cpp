@@ -2,6 +2,7 @@
 
 #include "../LightManager.h"
 #include "../core/Config.h"
+#include "../core/ConfigRegistry.h"
 #include "Console.h"
 #include "Light.h"
 
@@ -43,47 +44,11 @@ namespace ActorShadowLimiter {
     void WarnIfLightsHaveShadows() {
         bool foundShadows = false;
 
-        // Check hand-held lights
-        for (const auto& lightConfig : g_config.handHeldLights) {
-            auto* light = RE::TESForm::LookupByID<RE::TESObjectLIGH>(lightConfig.formId);
-            if (light && HasShadows(light)) {
+        // Check the light base forms of all configured lights, spells and enchanted armors
+        for (const auto& entry : GetConfigRegistry().Entries()) {
+            if (entry.light && HasShadows(entry.light)) {
+                DebugPrint("CONFIG", "Warning: Light base form of 0x%08X has shadows enabled", entry.formId);
                 foundShadows = true;
-                break;
-            }
-        }
-
-        // Check spells
-        if (!foundShadows) {
-            for (const auto& spellConfig : g_config.spells) {
-                auto* spell = RE::TESForm::LookupByID<RE::SpellItem>(spellConfig.formId);
-                if (spell && spell->effects.size() > 0) {
-                    for (auto* effect : spell->effects) {
-                        if (!effect || !effect->baseEffect) continue;
-                        auto* assocForm = effect->baseEffect->data.associatedForm;
-                        if (!assocForm) continue;
-
-                        auto* spellLight = assocForm->As<RE::TESObjectLIGH>();
-                        if (spellLight && HasShadows(spellLight)) {
-                            foundShadows = true;
-                            break;
-                        }
-                    }
-                    if (foundShadows) break;
-                }
-            }
-        }
-
-        // Check enchanted armors
-        if (!foundShadows) {
-            for (const auto& armorConfig : g_config.enchantedArmors) {
-                auto* armor = RE::TESForm::LookupByID<RE::TESObjectARMO>(armorConfig.formId);
-                if (armor) {
-                    auto* armorLight = GetLightFromEnchantedArmor(armor);
-                    if (armorLight && HasShadows(armorLight)) {
-                        foundShadows = true;
-                        break;
-                    }
-                }
             }
         }
 
@@ -98,50 +63,9 @@ namespace ActorShadowLimiter {
     }
 
     void LogUnrestoredLights() {
-        std::vector<std::pair<uint32_t, RE::TESObjectLIGH*>> configuredLights;
-
-        // Collect held lights
-        for (const auto& lightConfig : g_config.handHeldLights) {
-            auto* lightBase = RE::TESForm::LookupByID<RE::TESObjectLIGH>(lightConfig.formId);
-            if (lightBase) {
-                configuredLights.push_back({lightConfig.formId, lightBase});
-            }
-        }
-
-        // Collect spell lights
-        for (const auto& spellConfig : g_config.spells) {
-            auto* spell = RE::TESForm::LookupByID<RE::SpellItem>(spellConfig.formId);
-            if (spell && !spell->effects.empty()) {
-                for (auto* effect : spell->effects) {
-                    if (effect && effect->baseEffect) {
-                        auto* assocForm = effect->baseEffect->data.associatedForm;
-                        if (assocForm) {
-                            auto* spellLightBase = assocForm->As<RE::TESObjectLIGH>();
-                            if (spellLightBase) {
-                                configuredLights.push_back({spellConfig.formId, spellLightBase});
-                                break;
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        // Collect armor lights
-        for (const auto& armorConfig : g_config.enchantedArmors) {
-            auto* armor = RE::TESForm::LookupByID<RE::TESObjectARMO>(armorConfig.formId);
-            if (armor) {
-                auto* armorLight = GetLightFromEnchantedArmor(armor);
-                if (armorLight) {
-                    configuredLights.push_back({armorConfig.formId, armorLight});
-                }
-            }
-        }
-
-        // Check all configured lights
-        for (const auto& [formId, lightBase] : configuredLights) {
-            if (HasShadows(lightBase)) {
-                DebugPrint("UPDATE", "WARNING: Light 0x%08X base form still has shadows (not restored)", formId);
+        for (const auto& entry : GetConfigRegistry().Entries()) {
+            if (entry.light && HasShadows(entry.light)) {
+                DebugPrint("UPDATE", "WARNING: Light 0x%08X base form still has shadows (not restored)", entry.formId);
             }
         }
     }
@@ -55,4 +55,25 @@ namespace ActorShadowLimiter {
         }
     }
 
+    /**
+     * First light base form associated with any of the spell's or enchantment's effects.
+     */
+    RE::TESObjectLIGH* GetAssociatedLight(RE::MagicItem* a_item) {
+        if (!a_item) {
+            return nullptr;
+        }
+
+        for (auto* effect : a_item->effects) {
+            if (!effect || !effect->baseEffect) continue;
+
+            auto* assocForm = effect->baseEffect->data.associatedForm;
+            if (!assocForm) continue;
+
+            if (auto* light = assocForm->As<RE::TESObjectLIGH>()) {
+                return light;
+            }
+        }
+        return nullptr;
+    }
+
 }
@@ -0,0 +1,49 @@
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ActorShadowLimiter {
+
+    LightClusters::LightClusters(float mergeRadius, float radiusTolerance)
+        : mergeRadiusSq_(mergeRadius * mergeRadius),
+          radiusTolerance_(radiusTolerance),
+          inverseCellSize_(1.0f / std::max(mergeRadius, 1.0f)) {
+        cells_.Clear();
+    }
+
+    void LightClusters::Clear() {
+        cells_.Clear();
+        lights_.clear();
+    }
+
+    int32_t LightClusters::CellCoord(float value) const {
+        return static_cast<int32_t>(std::floor(value * inverseCellSize_));
+    }
+
+    bool LightClusters::Add(const RE::NiPoint3& pos, float radius, float* duplicateDistanceSq) {
+        int32_t cx = CellCoord(pos.x), cy = CellCoord(pos.y), cz = CellCoord(pos.z);
+
+        // Cells are one merge radius wide, so any light close enough is in a neighbouring cell
+        for (int32_t x = cx - 1; x <= cx + 1; ++x) {
+            for (int32_t y = cy - 1; y <= cy + 1; ++y) {
+                for (int32_t z = cz - 1; z <= cz + 1; ++z) {
+                    for (uint32_t i = cells_.Find(PackCellKey(x, y, z)); i != kEnd; i = lights_[i].next) {
+                        const auto& other = lights_[i];
+                        float dx = pos.x - other.pos.x, dy = pos.y - other.pos.y, dz = pos.z - other.pos.z;
+                        float distanceSq = dx * dx + dy * dy + dz * dz;
+                        if (distanceSq < mergeRadiusSq_ && std::abs(radius - other.radius) < radiusTolerance_) {
+                            if (duplicateDistanceSq) *duplicateDistanceSq = distanceSq;
+                            return false;
+                        }
+                    }
+                }
+            }
+        }
+
+        auto& head = cells_.Insert(PackCellKey(cx, cy, cz));
+        lights_.push_back({pos, radius, head});
+        head = static_cast<uint32_t>(lights_.size() - 1);
+        return true;
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "CellTable.h"
+#include "RE/Skyrim.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Groups lights that sit within a merge radius of each other and share a light radius, such as the
+     * first and third person copies of one light. Lights are hashed into cells one merge radius wide,
+     * so each insert only compares against the 27 surrounding cells. Keeps its storage across Clear().
+     */
+    class LightClusters {
+    public:
+        explicit LightClusters(float mergeRadius = 100.0f, float radiusTolerance = 0.1f);
+
+        void Clear();
+
+        /**
+         * Adds the light and returns true unless an added light already covers it. On a duplicate,
+         * `duplicateDistanceSq` receives the squared distance to the light it merged with.
+         */
+        bool Add(const RE::NiPoint3& pos, float radius, float* duplicateDistanceSq = nullptr);
+
+        size_t Size() const { return lights_.size(); }
+
+    private:
+        static constexpr uint32_t kEnd = UINT32_MAX;
+
+        struct Light {
+            RE::NiPoint3 pos;
+            float radius;
+            uint32_t next;  // Next light in the same cell
+        };
+
+        int32_t CellCoord(float value) const;
+
+        float mergeRadiusSq_;
+        float radiusTolerance_;
+        float inverseCellSize_;
+        CellTable<uint32_t, kEnd> cells_;  // Head of each cell's list
+        std::vector<Light> lights_;
+    };
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Read-only memory mapping of a whole file. The view stays valid until Close() or destruction.
+     */
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool Open(const std::filesystem::path& path);
+        void Close();
+
+        bool IsOpen() const { return data_ != nullptr; }
+        const std::byte* Data() const { return data_; }
+        std::size_t Size() const { return size_; }
+
+    private:
+        const std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+        void* fileHandle_ = nullptr;
+        void* mappingHandle_ = nullptr;
+    };
+
+}
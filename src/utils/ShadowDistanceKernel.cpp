@@ -0,0 +1,209 @@
+#include "ShadowDistanceKernel.h"
+
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__x86_64__)
+    #define ASL_KERNEL_X64 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+        #define ASL_TARGET_AVX2
+    #else
+        #define ASL_TARGET_AVX2 __attribute__((target("avx2")))
+    #endif
+#endif
+
+namespace ActorShadowLimiter {
+
+    void ShadowLightBatch::Clear() {
+        posX.clear();
+        posY.clear();
+        posZ.clear();
+        radius.clear();
+        distanceSq.clear();
+        inRange.clear();
+    }
+
+    void ShadowLightBatch::Push(const RE::NiPoint3& pos, float lightRadius) {
+        posX.push_back(pos.x);
+        posY.push_back(pos.y);
+        posZ.push_back(pos.z);
+        radius.push_back(lightRadius);
+    }
+
+    namespace {
+        struct KernelArgs {
+            const float* x;
+            const float* y;
+            const float* z;
+            const float* r;
+            float* distanceSq;
+            uint8_t* inRange;
+            RE::NiPoint3 origin;
+            float extra;
+        };
+
+        using Kernel = void (*)(const KernelArgs&, size_t begin, size_t end);
+
+        // A negative effective distance never matches, even though its square would
+        void EvaluateScalar(const KernelArgs& a, size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                float dx = a.x[i] - a.origin.x;
+                float dy = a.y[i] - a.origin.y;
+                float dz = a.z[i] - a.origin.z;
+                float distSq = dx * dx + dy * dy + dz * dz;
+                float effective = a.r[i] + a.extra;
+                a.distanceSq[i] = distSq;
+                a.inRange[i] = effective >= 0.0f && distSq <= effective * effective;
+            }
+        }
+
+#ifdef ASL_KERNEL_X64
+        void EvaluateSse2(const KernelArgs& a, size_t begin, size_t end) {
+            const __m128 ox = _mm_set1_ps(a.origin.x), oy = _mm_set1_ps(a.origin.y), oz = _mm_set1_ps(a.origin.z);
+            const __m128 extra = _mm_set1_ps(a.extra), zero = _mm_setzero_ps();
+
+            size_t i = begin;
+            for (; i + 4 <= end; i += 4) {
+                __m128 dx = _mm_sub_ps(_mm_loadu_ps(a.x + i), ox);
+                __m128 dy = _mm_sub_ps(_mm_loadu_ps(a.y + i), oy);
+                __m128 dz = _mm_sub_ps(_mm_loadu_ps(a.z + i), oz);
+                __m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+                __m128 effective = _mm_add_ps(_mm_loadu_ps(a.r + i), extra);
+                __m128 mask = _mm_and_ps(_mm_cmpge_ps(effective, zero),
+                                         _mm_cmple_ps(distSq, _mm_mul_ps(effective, effective)));
+                _mm_storeu_ps(a.distanceSq + i, distSq);
+
+                int bits = _mm_movemask_ps(mask);
+                for (int k = 0; k < 4; ++k) {
+                    a.inRange[i + k] = (bits >> k) & 1;
+                }
+            }
+            EvaluateScalar(a, i, end);
+        }
+
+        ASL_TARGET_AVX2 void EvaluateAvx2(const KernelArgs& a, size_t begin, size_t end) {
+            const __m256 ox = _mm256_set1_ps(a.origin.x), oy = _mm256_set1_ps(a.origin.y),
+                         oz = _mm256_set1_ps(a.origin.z);
+            const __m256 extra = _mm256_set1_ps(a.extra), zero = _mm256_setzero_ps();
+
+            size_t i = begin;
+            for (; i + 8 <= end; i += 8) {
+                __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(a.x + i), ox);
+                __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(a.y + i), oy);
+                __m256 dz = _mm256_sub_ps(_mm256_loadu_ps(a.z + i), oz);
+                __m256 distSq =
+                    _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+                __m256 effective = _mm256_add_ps(_mm256_loadu_ps(a.r + i), extra);
+                __m256 mask = _mm256_and_ps(_mm256_cmp_ps(effective, zero, _CMP_GE_OQ),
+                                            _mm256_cmp_ps(distSq, _mm256_mul_ps(effective, effective), _CMP_LE_OQ));
+                _mm256_storeu_ps(a.distanceSq + i, distSq);
+
+                int bits = _mm256_movemask_ps(mask);
+                for (int k = 0; k < 8; ++k) {
+                    a.inRange[i + k] = (bits >> k) & 1;
+                }
+            }
+
+            // The tail runs legacy SSE code, dirty upper halves would make every instruction there pay a transition
+            _mm256_zeroupper();
+            EvaluateSse2(a, i, end);
+        }
+
+        bool CpuSupportsAvx2() {
+    #if defined(_MSC_VER)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) return false;
+
+            // AVX state must also be enabled by the OS, not just present in the CPU
+            __cpuid(info, 1);
+            bool osXsave = (info[2] & (1 << 27)) != 0;
+            bool avx = (info[2] & (1 << 28)) != 0;
+            if (!osXsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+    #else
+            return __builtin_cpu_supports("avx2");
+    #endif
+        }
+#endif
+
+        struct SelectedKernel {
+            Kernel kernel;
+            const char* name;
+        };
+
+        const SelectedKernel& GetKernel() {
+            static const SelectedKernel selected = []() -> SelectedKernel {
+#ifdef ASL_KERNEL_X64
+                if (CpuSupportsAvx2()) return {EvaluateAvx2, "AVX2"};
+                return {EvaluateSse2, "SSE2"};  // Baseline on x64
+#else
+                return {EvaluateScalar, "scalar"};
+#endif
+            }();
+            return selected;
+        }
+
+        void RunKernel(Kernel kernel, ShadowLightBatch& batch, const RE::NiPoint3& origin, float extraDistance) {
+            size_t count = batch.Size();
+            batch.distanceSq.resize(count);
+            batch.inRange.resize(count);
+            if (count == 0) {
+                return;
+            }
+
+            KernelArgs args{batch.posX.data(),       batch.posY.data(),    batch.posZ.data(), batch.radius.data(),
+                            batch.distanceSq.data(), batch.inRange.data(), origin,            extraDistance};
+            kernel(args, 0, count);
+        }
+    }
+
+    void EvaluateShadowDistances(ShadowLightBatch& batch, const RE::NiPoint3& origin, float extraDistance) {
+        RunKernel(GetKernel().kernel, batch, origin, extraDistance);
+    }
+
+    bool EvaluateShadowDistancesWith(ShadowDistanceKernel kernel, ShadowLightBatch& batch, const RE::NiPoint3& origin,
+                                     float extraDistance) {
+        Kernel selected = nullptr;
+        switch (kernel) {
+            case ShadowDistanceKernel::Scalar:
+                selected = EvaluateScalar;
+                break;
+#ifdef ASL_KERNEL_X64
+            case ShadowDistanceKernel::Sse2:
+                selected = EvaluateSse2;
+                break;
+            case ShadowDistanceKernel::Avx2: {
+                static const bool avx2 = CpuSupportsAvx2();
+                selected = avx2 ? EvaluateAvx2 : nullptr;
+                break;
+            }
+#endif
+            default:
+                break;
+        }
+        if (!selected) {
+            return false;
+        }
+        RunKernel(selected, batch, origin, extraDistance);
+        return true;
+    }
+
+    void SortInRangeByDistance(const ShadowLightBatch& batch, std::vector<uint32_t>& order) {
+        order.clear();
+        for (uint32_t i = 0; i < batch.inRange.size(); ++i) {
+            if (batch.inRange[i]) {
+                order.push_back(i);
+            }
+        }
+        std::sort(order.begin(), order.end(), [&batch](uint32_t a, uint32_t b) {
+            float da = batch.distanceSq[a], db = batch.distanceSq[b];
+            return da != db ? da < db : a < b;
+        });
+    }
+
+    const char* GetShadowDistanceKernelName() { return GetKernel().name; }
+}
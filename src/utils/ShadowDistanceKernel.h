@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "RE/Skyrim.h"
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Light positions and radii gathered into parallel arrays, plus the per-light results of
+     * EvaluateShadowDistances. Clear() keeps the capacity so per-scan gathering stops allocating.
+     */
+    struct ShadowLightBatch {
+        std::vector<float> posX;
+        std::vector<float> posY;
+        std::vector<float> posZ;
+        std::vector<float> radius;
+
+        std::vector<float> distanceSq;  // From the origin of the last evaluation
+        std::vector<uint8_t> inRange;   // 1 if within radius + extra distance of it
+
+        void Clear();
+        void Push(const RE::NiPoint3& pos, float lightRadius);
+        size_t Size() const { return posX.size(); }
+    };
+
+    /**
+     * Fills `distanceSq` and `inRange` for every light in the batch. A light is in range when its
+     * distance to `origin` is at most its radius plus `extraDistance`, tested on squared values.
+     * Uses AVX2 or SSE2 when the CPU supports them, picked once at runtime, and scalar code otherwise.
+     */
+    void EvaluateShadowDistances(ShadowLightBatch& batch, const RE::NiPoint3& origin, float extraDistance);
+
+    enum class ShadowDistanceKernel : std::uint8_t { Scalar, Sse2, Avx2 };
+
+    /**
+     * EvaluateShadowDistances on one specific kernel, so the kernels can be compared against each other.
+     * Returns false without touching the batch if this build or CPU lacks the kernel.
+     */
+    bool EvaluateShadowDistancesWith(ShadowDistanceKernel kernel, ShadowLightBatch& batch, const RE::NiPoint3& origin,
+                                     float extraDistance);
+
+    /**
+     * Indices of the in-range lights of an evaluated batch, closest first.
+     */
+    void SortInRangeByDistance(const ShadowLightBatch& batch, std::vector<uint32_t>& order);
+
+    const char* GetShadowDistanceKernelName();
+}
@@ -0,0 +1,107 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+
+#include "SKSE/SKSE.h"
+
+namespace ActorShadowLimiter {
+
+    TaskScheduler& TaskScheduler::GetSingleton() {
+        // Never destroyed, the detached thread may still be waiting on it at exit
+        static auto* instance = new TaskScheduler();
+        return *instance;
+    }
+
+    void TaskScheduler::Schedule(std::chrono::milliseconds delay, Task task) {
+        std::call_once(started_, [this]() { std::thread([this]() { Run(); }).detach(); });
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto now = Clock::now();
+            if (pending_ == 0) {
+                // The wheel idled, restart its clock from now
+                nextTick_ = now + kTick;
+            }
+
+            // Slots count from the cursor's tick, which may lie most of a tick (or more, on a late wake) in
+            // the past. Count the delay from there and round up so a task never runs early, and always wait
+            // at least one tick.
+            Clock::duration tick = kTick;
+            auto sinceCursor = std::max(now - (nextTick_ - tick), Clock::duration::zero());
+            auto wait = std::max(Clock::duration(delay), Clock::duration::zero()) + sinceCursor;
+            size_t ticks = std::max<size_t>(static_cast<size_t>((wait + tick - Clock::duration(1)) / tick), 1);
+
+            wheel_[(cursor_ + ticks) % kSlots].push_back({(ticks - 1) / kSlots, std::move(task)});
+            ++pending_;
+        }
+        wake_.notify_one();
+    }
+
+    void TaskScheduler::ScheduleSequence(std::vector<Step> steps) {
+        if (steps.empty()) {
+            return;
+        }
+        ScheduleStep(std::make_shared<std::vector<Step>>(std::move(steps)), 0);
+    }
+
+    void TaskScheduler::ScheduleStep(std::shared_ptr<std::vector<Step>> steps, size_t index) {
+        auto delay = (*steps)[index].delay;
+        Schedule(delay, [this, steps, index]() {
+            (*steps)[index].task();
+            if (index + 1 < steps->size()) {
+                ScheduleStep(steps, index + 1);
+            }
+        });
+    }
+
+    void TaskScheduler::Run() {
+        std::vector<Task> due;
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [this]() { return pending_ > 0; });
+            if (wake_.wait_until(lock, nextTick_, [this]() { return pending_ == 0; })) {
+                continue;
+            }
+
+            // Catch up on every tick that has passed, a late wake still keeps the order of tasks
+            auto now = Clock::now();
+            while (nextTick_ <= now && pending_ > 0) {
+                nextTick_ += kTick;
+                cursor_ = (cursor_ + 1) % kSlots;
+
+                // Compact in place so entries keep the order they were scheduled in
+                auto& slot = wheel_[cursor_];
+                size_t kept = 0;
+                for (auto& entry : slot) {
+                    if (entry.rounds > 0) {
+                        --entry.rounds;
+                        if (&slot[kept] != &entry) {
+                            slot[kept] = std::move(entry);
+                        }
+                        ++kept;
+                    } else {
+                        due.push_back(std::move(entry.task));
+                        --pending_;
+                    }
+                }
+                slot.resize(kept);
+            }
+
+            if (due.empty()) {
+                continue;
+            }
+
+            // One task per tick no matter how many sequences are due
+            lock.unlock();
+            if (auto* tasks = SKSE::GetTaskInterface()) {
+                tasks->AddTask([batch = std::move(due)]() {
+                    for (const auto& task : batch) {
+                        task();
+                    }
+                });
+            }
+            due.clear();
+            lock.lock();
+        }
+    }
+}
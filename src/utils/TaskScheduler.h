@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ActorShadowLimiter {
+
+    /**
+     * Runs delayed work on the main thread from one background thread. Pending tasks sit on a hashed
+     * timer wheel with one slot per frame-length tick, and every task due on a tick is handed to the
+     * SKSE task interface as a single batch. The thread is started on first use and lives for the
+     * rest of the session, so scheduling never creates threads.
+     */
+    class TaskScheduler {
+    public:
+        using Task = std::function<void()>;
+
+        struct Step {
+            std::chrono::milliseconds delay;  // From the previous step running, or from scheduling for the first
+            Task task;
+        };
+
+        static TaskScheduler& GetSingleton();
+
+        // Runs `task` on the main thread once `delay` has passed
+        void Schedule(std::chrono::milliseconds delay, Task task);
+
+        // Runs the steps on the main thread in order, each one its delay after the previous one ran
+        void ScheduleSequence(std::vector<Step> steps);
+
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // About one frame per tick and four seconds per revolution, longer delays wait out extra rounds
+        static constexpr auto kTick = std::chrono::milliseconds(16);
+        static constexpr size_t kSlots = 256;
+
+        struct Entry {
+            size_t rounds;  // Revolutions left before the entry is due when its slot comes up
+            Task task;
+        };
+
+        TaskScheduler() = default;
+
+        void Run();
+        void ScheduleStep(std::shared_ptr<std::vector<Step>> steps, size_t index);
+
+        std::array<std::vector<Entry>, kSlots> wheel_;
+        size_t cursor_ = 0;   // Slot of the last processed tick
+        size_t pending_ = 0;  // Entries on the wheel
+        Clock::time_point nextTick_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::once_flag started_;
+    };
+}
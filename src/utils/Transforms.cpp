@@ -1,6 +1,7 @@
 #include "Transforms.h"
 
 #include "../core/Config.h"
+#include "../core/ConfigRegistry.h"
 #include "../utils/Console.h"
 
 namespace ActorShadowLimiter {
@@ -104,14 +105,7 @@ namespace ActorShadowLimiter {
 
     void AdjustHeldLightPosition(RE::Actor* actor, uint32_t lightFormId) {
         // Find the equipped light's config
-        const HandHeldLightConfig* lightConfig = nullptr;
-
-        for (const auto& config : g_config.handHeldLights) {
-            if (config.formId == lightFormId) {
-                lightConfig = &config;
-                break;
-            }
-        }
+        const HandHeldLightConfig* lightConfig = GetConfigRegistry().Find(lightFormId).AsHandHeldLight();
 
         if (!lightConfig) {
             DebugPrint("TRANSFORM", "No configuration found for hand-held light 0x%08X", lightFormId);
@@ -127,14 +121,7 @@ namespace ActorShadowLimiter {
         if (!actor) return;
 
         // Find the spell's config
-        const SpellConfig* spellConfig = nullptr;
-
-        for (const auto& config : g_config.spells) {
-            if (config.formId == spellFormId) {
-                spellConfig = &config;
-                break;
-            }
-        }
+        const SpellConfig* spellConfig = GetConfigRegistry().Find(spellFormId).AsSpell();
 
         if (!spellConfig) {
             DebugPrint("TRANSFORM", "No configuration found for spell 0x%08X", spellFormId);
@@ -148,14 +135,7 @@ namespace ActorShadowLimiter {
 
     void AdjustEnchantmentLightPosition(RE::Actor* actor, uint32_t armorFormId) {
         if (!actor) return;
-        const EnchantedArmorConfig* armorConfig = nullptr;
-
-        for (const auto& config : g_config.enchantedArmors) {
-            if (config.formId == armorFormId) {
-                armorConfig = &config;
-                break;
-            }
-        }
+        const EnchantedArmorConfig* armorConfig = GetConfigRegistry().Find(armorFormId).AsEnchantedArmor();
 
         if (!armorConfig) {
             DebugPrint("TRANSFORM", "No configuration found for enchanted armor 0x%08X", armorFormId);
@@ -0,0 +1,118 @@
+// ActorGrid against a brute-force scan while IDs are inserted, moved and removed, and the tracker's
+// range queries after a slot is recycled for an actor somewhere else.
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "TestCheck.h"
+#include "actor/ActorGrid.h"
+#include "actor/ActorTracker.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    constexpr uint32_t kMaxIds = 256;
+
+    std::vector<uint32_t> BruteForceInRange(const std::vector<RE::NiPoint3>& positions,
+                                            const std::vector<bool>& present, const RE::NiPoint3& center,
+                                            float radius) {
+        std::vector<uint32_t> ids;
+        for (uint32_t id = 0; id < kMaxIds; ++id) {
+            if (present[id] && positions[id].GetSquaredDistance(center) <= radius * radius) {
+                ids.push_back(id);
+            }
+        }
+        return ids;
+    }
+
+    void CheckGrid(std::mt19937& rng) {
+        ActorGrid grid;
+        grid.Reset(500.0f, kMaxIds);
+        std::vector<RE::NiPoint3> positions(kMaxIds);
+        std::vector<bool> present(kMaxIds, false);
+        std::uniform_real_distribution<float> coord(-4000.0f, 4000.0f);
+
+        for (int step = 0; step < 20000; ++step) {
+            uint32_t id = rng() % kMaxIds;
+            if (rng() % 3 == 0) {
+                grid.Remove(id);
+                present[id] = false;
+            } else {
+                // Inserting a present ID moves it, often into another cell
+                positions[id] = {coord(rng), coord(rng), coord(rng) * 0.1f};
+                grid.Insert(id, positions[id]);
+                present[id] = true;
+            }
+
+            if (step % 97 == 0) {
+                size_t presentCount = std::count(present.begin(), present.end(), true);
+                CHECK(grid.Size() == presentCount);
+
+                RE::NiPoint3 center{coord(rng), coord(rng), 0.0f};
+                float radius = 200.0f + static_cast<float>(rng() % 3000);
+                std::vector<uint32_t> found;
+                grid.ForEachInRange(center, radius, [&](uint32_t foundId, float) { found.push_back(foundId); });
+                std::sort(found.begin(), found.end());
+                CHECK(found == BruteForceInRange(positions, present, center, radius));
+
+                // The nearest five, closest first: their distances must match the five smallest in range
+                std::vector<std::pair<float, uint32_t>> nearest;
+                grid.FindNearest(center, 5, radius, [](uint32_t) { return true; }, nearest);
+                std::vector<float> expected;
+                for (uint32_t expectedId : BruteForceInRange(positions, present, center, radius)) {
+                    expected.push_back(positions[expectedId].GetSquaredDistance(center));
+                }
+                std::sort(expected.begin(), expected.end());
+                CHECK(nearest.size() == std::min<size_t>(5, expected.size()));
+                for (size_t i = 0; i < nearest.size() && i < expected.size(); ++i) {
+                    auto [distanceSq, nearestId] = nearest[i];
+                    CHECK(distanceSq == expected[i]);
+                    CHECK(present[nearestId] && positions[nearestId].GetSquaredDistance(center) == distanceSq);
+                }
+            }
+        }
+
+        for (uint32_t id = 0; id < kMaxIds; ++id) {
+            grid.Remove(id);
+            CHECK(!grid.Contains(id));
+        }
+        CHECK(grid.Size() == 0);
+    }
+
+    // A slot freed by one actor and taken by another must be found at the new actor's position
+    void CheckRecycledSlot() {
+        auto& tracker = ActorTracker::GetSingleton();
+        RE::Actor far(0xFF000A01);
+        RE::Actor near(0xFF000A02);
+        far.position = {9000.0f, 0.0f, 0.0f};
+        near.position = {100.0f, 0.0f, 0.0f};
+        RE::HostForms::Table()[far.GetFormID()] = &far;
+        RE::HostForms::Table()[near.GetFormID()] = &near;
+
+        tracker.AddActor(far.GetFormID());
+        tracker.RefreshCachedPositions();
+        CHECK(tracker.GetActorIdsInRange(1000.0f).empty());
+        CHECK(tracker.GetActorIdsInRange(10000.0f) == std::vector<uint32_t>{far.GetFormID()});
+
+        tracker.RemoveActor(far.GetFormID());
+        tracker.AddActor(near.GetFormID());
+        CHECK(tracker.GetActorIdsInRange(1000.0f) == std::vector<uint32_t>{near.GetFormID()});
+        CHECK(tracker.GetNearestActorIds(4, 1000.0f) == std::vector<uint32_t>{near.GetFormID()});
+
+        // An actor that no longer resolves leaves nothing of the previous occupant behind
+        tracker.RemoveActor(near.GetFormID());
+        tracker.AddActor(0xFF000A03);
+        CHECK(tracker.GetActorIdsInRange(10000.0f).empty());
+
+        tracker.ClearAllActors();
+        RE::HostForms::Table().clear();
+    }
+}
+
+int main() {
+    std::mt19937 rng(99);
+    CheckGrid(rng);
+    CheckRecycledSlot();
+    return TestCheck::Finish("ActorGridTest");
+}
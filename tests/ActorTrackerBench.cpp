@@ -0,0 +1,144 @@
+// Lookup and insert throughput of the actor tracker under concurrent access, next to the mutex-guarded
+// std::map it replaced. Reader threads look actors up while one writer keeps tracking and untracking them.
+// Usage: ActorTrackerBench [milliseconds per phase], defaults to 1000.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "actor/ActorTracker.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    constexpr uint32_t kFirstFormId = 0xFF000800;
+    constexpr uint32_t kPoolSize = 4096;  // Distinct actors, more than the tracker holds at once
+    constexpr uint32_t kLiveTarget = 600;
+
+    // The previous store: every access under one mutex, actors owned by map nodes
+    class MapTracker {
+    public:
+        bool HasActor(uint32_t actorFormId) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return actors_.find(actorFormId) != actors_.end();
+        }
+        void AddActor(uint32_t actorFormId) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            actors_.try_emplace(actorFormId, actorFormId);
+        }
+        void RemoveActor(uint32_t actorFormId) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            actors_.erase(actorFormId);
+        }
+
+    private:
+        std::mutex mutex_;
+        std::map<uint32_t, TrackedActor> actors_;
+    };
+
+    struct PhaseResult {
+        double lookupsPerSecond = 0.0;
+        double writesPerSecond = 0.0;
+    };
+
+    template <class Tracker>
+    PhaseResult RunPhase(Tracker& tracker, int readerCount, std::chrono::milliseconds duration,
+                         std::unordered_set<uint32_t>& live) {
+        std::atomic<bool> running{true};
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> hits{0};
+        uint64_t writes = 0;
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < readerCount; ++r) {
+            readers.emplace_back([&, r]() {
+                std::mt19937 rng(100 + r);
+                uint64_t localLookups = 0;
+                uint64_t localHits = 0;
+                while (running.load(std::memory_order_relaxed)) {
+                    for (int i = 0; i < 256; ++i) {
+                        localHits += tracker.HasActor(kFirstFormId + rng() % kPoolSize) ? 1 : 0;
+                    }
+                    localLookups += 256;
+                }
+                lookups += localLookups;
+                hits += localHits;
+            });
+        }
+
+        // The writer runs on this thread and keeps the live set near its target size
+        std::mt19937 rng(7);
+        auto start = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - start < duration) {
+            for (int i = 0; i < 64; ++i) {
+                uint32_t formId = kFirstFormId + rng() % kPoolSize;
+                if (live.count(formId) || live.size() >= kLiveTarget) {
+                    if (!live.empty()) {
+                        uint32_t victim = live.count(formId) ? formId : *live.begin();
+                        tracker.RemoveActor(victim);
+                        live.erase(victim);
+                    }
+                } else {
+                    tracker.AddActor(formId);
+                    live.insert(formId);
+                }
+                ++writes;
+            }
+        }
+        running = false;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return {static_cast<double>(lookups.load()) / seconds, static_cast<double>(writes) / seconds};
+    }
+
+    // Single-threaded check that the tracker agrees with the set of actors the writer left live
+    bool MatchesLiveSet(ActorTracker& tracker, const std::unordered_set<uint32_t>& live) {
+        for (uint32_t i = 0; i < kPoolSize; ++i) {
+            uint32_t formId = kFirstFormId + i;
+            if (tracker.HasActor(formId) != (live.count(formId) > 0)) {
+                std::fprintf(stderr, "tracker disagrees on 0x%08X\n", formId);
+                return false;
+            }
+            auto handle = tracker.FindHandle(formId);
+            if (handle && tracker.Resolve(handle)->GetActorFormId() != formId) {
+                std::fprintf(stderr, "handle for 0x%08X resolves to another actor\n", formId);
+                return false;
+            }
+        }
+        return tracker.GetTrackedActorCount() == live.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    auto duration = std::chrono::milliseconds(argc > 1 ? std::strtol(argv[1], nullptr, 10) : 1000);
+    int hardwareThreads = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
+
+    auto& tracker = ActorTracker::GetSingleton();
+    std::unordered_set<uint32_t> trackerLive;
+    MapTracker mapTracker;
+    std::unordered_set<uint32_t> mapLive;
+
+    std::printf("%-24s %18s %18s\n", "readers", "slot map lookups/s", "std::map lookups/s");
+    std::vector<int> readerCounts = {0, 1, 3};
+    if (hardwareThreads - 1 > 3) {
+        readerCounts.push_back(hardwareThreads - 1);
+    }
+    for (int readers : readerCounts) {
+        auto slotMap = RunPhase(tracker, readers, duration, trackerLive);
+        if (!MatchesLiveSet(tracker, trackerLive)) {
+            return 1;
+        }
+        auto map = RunPhase(mapTracker, readers, duration, mapLive);
+        std::printf("%-24d %18.3e %18.3e\n", readers, slotMap.lookupsPerSecond, map.lookupsPerSecond);
+        std::printf("%-24s %18.3e %18.3e\n", "  writer inserts/removes", slotMap.writesPerSecond, map.writesPerSecond);
+    }
+    return 0;
+}
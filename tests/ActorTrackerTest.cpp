@@ -0,0 +1,75 @@
+// Tracker access rules: actor data is main thread only once bound, and a handle taken before its slot
+// was reused for another actor no longer resolves. Also churns actors through enough removals that the
+// form ID index is rebuilt many times, and checks lookups still agree with what was added.
+
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "TestCheck.h"
+#include "actor/ActorTracker.h"
+
+using namespace ActorShadowLimiter;
+
+int main() {
+    auto& tracker = ActorTracker::GetSingleton();
+    tracker.BindToMainThread();
+
+    constexpr uint32_t kFirst = 0xFF000C01;
+    constexpr uint32_t kSecond = 0xFF000C02;
+    CHECK(tracker.GetOrCreateActor(kFirst) != nullptr);
+    auto firstHandle = tracker.FindHandle(kFirst);
+    CHECK(static_cast<bool>(firstHandle));
+
+    // Off the main thread only lookups work, actor data and changes are refused
+    std::thread worker([&] {
+        CHECK(tracker.HasActor(kFirst));
+        CHECK(static_cast<bool>(tracker.FindHandle(kFirst)));
+        CHECK(tracker.GetActor(kFirst) == nullptr);
+        CHECK(tracker.Resolve(firstHandle) == nullptr);
+        CHECK(!tracker.GetOrCreateHandle(kSecond));
+        tracker.RemoveActor(kFirst);
+    });
+    worker.join();
+    CHECK(tracker.HasActor(kFirst));
+    CHECK(!tracker.HasActor(kSecond));
+    CHECK(tracker.Resolve(firstHandle) != nullptr);
+
+    // The freed slot goes to the next actor, the old handle must not resolve to it
+    tracker.RemoveActor(kFirst);
+    auto* second = tracker.GetOrCreateActor(kSecond);
+    CHECK(second != nullptr);
+    auto secondHandle = tracker.FindHandle(kSecond);
+    CHECK(secondHandle.index == firstHandle.index);
+    CHECK(tracker.Resolve(firstHandle) == nullptr);
+    CHECK(tracker.Resolve(secondHandle) == second);
+
+    tracker.ClearAllActors();
+
+    // Random adds and removes over a pool larger than the live set, the tombstones they leave behind
+    // force regular index rebuilds
+    constexpr uint32_t kChurnBase = 0xFF001000;
+    constexpr uint32_t kPoolSize = 4096;
+    constexpr size_t kLive = 600;
+    std::mt19937 rng(7);
+    std::unordered_set<uint32_t> live;
+    bool consistent = true;
+    for (int op = 0; op < 500000 && consistent; ++op) {
+        uint32_t formId = kChurnBase + rng() % kPoolSize;
+        if (live.count(formId) || live.size() >= kLive) {
+            uint32_t victim = live.count(formId) ? formId : *live.begin();
+            tracker.RemoveActor(victim);
+            live.erase(victim);
+            consistent = !tracker.HasActor(victim);
+        } else {
+            tracker.AddActor(formId);
+            live.insert(formId);
+            consistent = tracker.HasActor(formId);
+        }
+        consistent = consistent && tracker.GetTrackedActorCount() == live.size();
+    }
+    CHECK(consistent);
+    tracker.ClearAllActors();
+    CHECK(tracker.GetTrackedActorCount() == 0);
+    return TestCheck::Finish("ActorTrackerTest");
+}
@@ -0,0 +1,210 @@
+// Round trip of the compiled config cache: JSON -> ConfigCacheWriter -> MappedFile -> ConfigCacheReader must
+// reproduce every parsed field exactly, and damaged cache files must be rejected.
+
+#include <bit>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TestCheck.h"
+#include "core/ConfigCache.h"
+#include "utils/Hash.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    struct SourceFile {
+        std::string name;
+        std::string text;
+        ConfigFileFingerprint fingerprint;
+        std::vector<ParsedLightEntry> lights;
+        std::string error;
+    };
+
+    bool SameFloat(float a, float b) { return std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b); }
+
+    bool SameEntry(const ParsedLightEntry& a, const ParsedLightEntry& b) {
+        return a.type == b.type && a.formId == b.formId && a.plugin == b.plugin && a.rootNodeName == b.rootNodeName &&
+               a.lightNodeName == b.lightNodeName && SameFloat(a.offsetX, b.offsetX) &&
+               SameFloat(a.offsetY, b.offsetY) && SameFloat(a.offsetZ, b.offsetZ) &&
+               SameFloat(a.rotateX, b.rotateX) && SameFloat(a.rotateY, b.rotateY) &&
+               SameFloat(a.rotateZ, b.rotateZ) && a.isRule == b.isRule && a.keyword == b.keyword &&
+               SameFloat(a.minRadius, b.minRadius);
+    }
+
+    std::string RandomFloat(std::mt19937& rng) {
+        static const char* kEdgeValues[] = {"0.0", "-0.0", "1e-7", "-123456.789", "3.4028234e38", "0.1"};
+        if (rng() % 4 == 0) {
+            return kEdgeValues[rng() % std::size(kEdgeValues)];
+        }
+        std::uniform_real_distribution<float> dist(-5000.0f, 5000.0f);
+        char buffer[64];
+        std::snprintf(buffer, sizeof(buffer), "%.9g", dist(rng));
+        return buffer;
+    }
+
+    std::string RandomEntry(std::mt19937& rng, size_t index) {
+        static const char* kTypes[] = {"HandheldLight", "SpellLight", "EnchantmentLight"};
+        std::string entry = "{\"type\": \"" + std::string(kTypes[rng() % 3]) + "\"";
+        entry += ", \"formId\": \"0x" + std::to_string(100000 + index) + "\"";
+        entry += ", \"plugin\": \"Plugin" + std::to_string(rng() % 5) + ".esp\"";
+        entry += ", \"rootNodeName\": \"Root" + std::to_string(index) + "\"";
+        entry += ", \"lightNodeName\": \"AttachLight\"";
+        for (const char* key : {"offsetX", "offsetY", "offsetZ", "rotateX", "rotateY", "rotateZ"}) {
+            if (rng() % 3 != 0) {
+                entry += ", \"" + std::string(key) + "\": " + RandomFloat(rng);
+            }
+        }
+        if (rng() % 4 == 0) {
+            entry += ", \"rule\": true, \"keyword\": \"MagicLight\", \"minRadius\": " + RandomFloat(rng);
+        }
+        return entry + "}";
+    }
+
+    std::vector<SourceFile> MakeSources(std::mt19937& rng) {
+        std::vector<SourceFile> files;
+        for (size_t i = 0; i < 64; ++i) {
+            SourceFile file;
+            file.name = "Light" + std::to_string(i) + ".json";
+            size_t count = rng() % 4;
+            if (count == 0) {
+                file.text = RandomEntry(rng, i * 8);
+            } else {
+                file.text += '[';
+                for (size_t j = 0; j < count; ++j) {
+                    if (j > 0) {
+                        file.text += ", ";
+                    }
+                    file.text += RandomEntry(rng, i * 8 + j);
+                }
+                file.text += "]";
+            }
+            files.push_back(std::move(file));
+        }
+
+        // A file that failed to parse is cached with its error and no lights
+        SourceFile broken;
+        broken.name = "Broken.json";
+        broken.text = "{\"type\": \"HandheldLight\", \"formId\": }";
+        files.push_back(std::move(broken));
+
+        for (auto& file : files) {
+            file.fingerprint.size = file.text.size();
+            file.fingerprint.lastWriteTime = static_cast<std::int64_t>(rng()) << 20;
+            file.fingerprint.contentHash = Fnv1a64(file.text);
+            if (!ParseLightConfig(file.text, file.lights, file.error)) {
+                file.lights.clear();
+            }
+        }
+        return files;
+    }
+
+    void WriteBytes(const std::filesystem::path& path, const std::string& bytes) {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    }
+
+    std::string ReadBytes(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+}
+
+int main() {
+    CHECK(Fnv1a64("") == kFnv1aOffsetBasis);
+    CHECK(Fnv1a64("a") == 0xAF63DC4C8601EC8Cull);
+    CHECK(Fnv1a64("bar", Fnv1a64("foo")) == Fnv1a64("foobar"));
+
+    auto dir = std::filesystem::temp_directory_path() / "ActorShadowsConfigCacheTest";
+    std::filesystem::create_directories(dir);
+    auto cachePath = dir / "ActorShadows.cache";
+
+    std::mt19937 rng(1234);
+    auto sources = MakeSources(rng);
+    CHECK(!sources.back().error.empty());
+
+    {
+        ConfigCacheWriter writer;
+        for (const auto& file : sources) {
+            writer.AddFile(file.name, file.fingerprint, file.lights, file.error);
+        }
+        CHECK(writer.Write(cachePath));
+        CHECK(!std::filesystem::exists(dir / "ActorShadows.cache.tmp"));
+    }
+
+    {
+        ConfigCacheReader reader;
+        CHECK(reader.Open(cachePath));
+        CHECK(reader.FileCount() == sources.size());
+        CHECK(reader.FindFile("Missing.json") == nullptr);
+
+        std::vector<ParsedLightEntry> lights;
+        std::string error;
+        for (const auto& file : sources) {
+            const auto* cached = reader.FindFile(file.name);
+            CHECK(cached != nullptr);
+            if (!cached) {
+                continue;
+            }
+            CHECK(cached->size == file.fingerprint.size);
+            CHECK(cached->lastWriteTime == file.fingerprint.lastWriteTime);
+            CHECK(cached->contentHash == file.fingerprint.contentHash);
+            CHECK(reader.ReadFile(*cached, lights, error));
+            CHECK(error == file.error);
+            CHECK(lights.size() == file.lights.size());
+            for (size_t i = 0; i < std::min(lights.size(), file.lights.size()); ++i) {
+                CHECK(SameEntry(lights[i], file.lights[i]));
+            }
+        }
+    }
+
+    // Truncated, resized or re-versioned caches must be refused rather than read out of bounds
+    std::string bytes = ReadBytes(cachePath);
+    {
+        ConfigCacheReader reader;
+        WriteBytes(cachePath, bytes.substr(0, bytes.size() - 1));
+        CHECK(!reader.Open(cachePath));
+        WriteBytes(cachePath, bytes.substr(0, sizeof(CachedConfigHeader) - 1));
+        CHECK(!reader.Open(cachePath));
+        WriteBytes(cachePath, bytes + "x");
+        CHECK(!reader.Open(cachePath));
+
+        std::string wrongVersion = bytes;
+        wrongVersion[offsetof(CachedConfigHeader, version)] ^= 0x7F;
+        WriteBytes(cachePath, wrongVersion);
+        CHECK(!reader.Open(cachePath));
+        CHECK(!reader.IsOpen());
+        CHECK(reader.FindFile(sources.front().name) == nullptr);
+
+        WriteBytes(cachePath, bytes);
+        CHECK(reader.Open(cachePath));
+    }
+
+    // A string reference pointing past the pool is rejected when the file is read
+    {
+        std::string corrupt = bytes;
+        auto* header = reinterpret_cast<CachedConfigHeader*>(corrupt.data());
+        auto* records = reinterpret_cast<CachedConfigFile*>(corrupt.data() + sizeof(CachedConfigHeader));
+        size_t index = 0;
+        while (index < header->fileCount && records[index].lightCount == 0) {
+            ++index;
+        }
+        CHECK(index < header->fileCount);
+        auto* lightRecords = reinterpret_cast<CachedLightRecord*>(records + header->fileCount);
+        lightRecords[records[index].firstLight].plugin.offset = header->stringPoolSize;
+        lightRecords[records[index].firstLight].plugin.length = 1;
+        WriteBytes(cachePath, corrupt);
+
+        ConfigCacheReader reader;
+        CHECK(reader.Open(cachePath));
+        std::vector<ParsedLightEntry> lights;
+        std::string error;
+        CHECK(!reader.ReadFile(records[index], lights, error));
+    }
+
+    std::filesystem::remove_all(dir);
+    return TestCheck::Finish("ConfigCacheTest");
+}
@@ -0,0 +1,23 @@
+// Definitions the tracker needs from modules that talk to the game, replaced by inert host versions:
+// default config, an empty config registry and silent debug logging.
+
+#include "core/Config.h"
+#include "core/ConfigRegistry.h"
+#include "utils/Console.h"
+
+namespace ActorShadowLimiter {
+    const Config& GetConfig() {
+        static const Config config{};
+        return config;
+    }
+
+    const ConfigRegistry& GetConfigRegistry() {
+        static const ConfigRegistry registry{};
+        return registry;
+    }
+
+    ConfigLookup ConfigRegistry::Find(uint32_t) const { return {}; }
+
+    void DebugPrint(const std::string&, const char*, ...) {}
+    void DebugPrint(const std::string&, RE::Actor*, const char*, ...) {}
+}
@@ -0,0 +1,104 @@
+// Parses a synthetic corpus of light config documents, the way a large modlist ships them.
+// Usage: JsonParserBench [fileCount], defaults to 10000 files.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "core/JsonParser.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    std::string MakeEntry(size_t index, bool withPlugin) {
+        static const char* kTypes[] = {"HandheldLight", "SpellLight", "EnchantmentLight"};
+        char buffer[512];
+        std::snprintf(buffer, sizeof(buffer),
+                      "{\n"
+                      "    \"type\": \"%s\",\n"
+                      "    \"formId\": \"0x%06zX\",\n"
+                      "%s"
+                      "    \"rootNodeName\": \"TorchFire%zu\",\n"
+                      "    \"lightNodeName\": \"AttachLight\",\n"
+                      "    \"offsetX\": %.1f,\n"
+                      "    \"offsetY\": %.1f,\n"
+                      "    \"offsetZ\": -2.0,\n"
+                      "    \"rotateX\": -20.0,\n"
+                      "    \"rotateY\": 0.0,\n"
+                      "    \"rotateZ\": %zu\n"
+                      "}",
+                      kTypes[index % 3], 0x1D4EC + index, withPlugin ? "    \"plugin\": \"Skyrim.esm\",\n" : "", index,
+                      static_cast<double>(index % 7), 30.0 + static_cast<double>(index % 11), index % 360);
+        return buffer;
+    }
+
+    // Mostly single entries, with some bundles and plugin packs mixed in
+    std::string MakeDocument(size_t index, size_t& entryCount) {
+        switch (index % 10) {
+            case 0: {
+                std::string doc = "[\n";
+                for (size_t i = 0; i < 4; ++i) {
+                    doc += (i ? ",\n" : "") + MakeEntry(index * 16 + i, true);
+                }
+                entryCount = 4;
+                return doc + "\n]\n";
+            }
+            case 1: {
+                std::string doc = "{\n    \"plugin\": \"QwibNewLanterns.esp\",\n    \"unknownKey\": [1, 2, {\"a\": 3}],\n";
+                doc += "    \"lights\": [\n";
+                for (size_t i = 0; i < 8; ++i) {
+                    doc += (i ? ",\n" : "") + MakeEntry(index * 16 + i, false);
+                }
+                entryCount = 8;
+                return doc + "\n    ]\n}\n";
+            }
+            default:
+                entryCount = 1;
+                return MakeEntry(index, true) + "\n";
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t fileCount = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+
+    std::vector<std::string> corpus;
+    corpus.reserve(fileCount);
+    size_t expectedEntries = 0;
+    size_t totalBytes = 0;
+    for (size_t i = 0; i < fileCount; ++i) {
+        size_t entryCount = 0;
+        corpus.push_back(MakeDocument(i, entryCount));
+        expectedEntries += entryCount;
+        totalBytes += corpus.back().size();
+    }
+
+    constexpr int kRuns = 5;
+    double bestMs = 0.0;
+    std::vector<ParsedLightEntry> lights;
+    std::string error;
+    for (int run = 0; run < kRuns; ++run) {
+        size_t parsedEntries = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& doc : corpus) {
+            if (!ParseLightConfig(doc, lights, error)) {
+                std::fprintf(stderr, "parse failed: %s\n", error.c_str());
+                return 1;
+            }
+            parsedEntries += lights.size();
+        }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (parsedEntries != expectedEntries) {
+            std::fprintf(stderr, "parsed %zu entries, expected %zu\n", parsedEntries, expectedEntries);
+            return 1;
+        }
+        bestMs = run == 0 ? ms : std::min(bestMs, ms);
+    }
+
+    std::printf("%zu files, %zu entries, %.1f KiB: best of %d runs %.3f ms (%.1f MiB/s, %.2f us/file)\n", fileCount,
+                expectedEntries, totalBytes / 1024.0, kRuns, bestMs, totalBytes / (1024.0 * 1024.0) / (bestMs / 1000.0),
+                bestMs * 1000.0 / static_cast<double>(fileCount));
+    return 0;
+}
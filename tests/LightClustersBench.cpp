@@ -0,0 +1,100 @@
+// Duplicate light clustering on scenes of 10 to 10,000 lights, next to the pairwise comparison it
+// replaced. Both must agree on every light. Usage: LightClustersBench [maxLights], defaults to 10000.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "utils/LightClusters.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    constexpr float kMergeRadius = 100.0f;
+    constexpr float kRadiusTolerance = 0.1f;
+
+    struct SceneLight {
+        RE::NiPoint3 pos;
+        float radius;
+    };
+
+    // Lights spread over a cell roughly 200 units apart per light, a third of them with a close copy
+    std::vector<SceneLight> MakeScene(size_t count, std::mt19937& rng) {
+        float extent = 200.0f * std::cbrt(static_cast<float>(count)) + 500.0f;
+        std::uniform_real_distribution<float> coord(-extent, extent);
+        std::uniform_real_distribution<float> jitter(-40.0f, 40.0f);
+        std::vector<SceneLight> lights;
+        lights.reserve(count);
+        while (lights.size() < count) {
+            float radius = 256.0f + static_cast<float>(rng() % 8) * 64.0f;
+            SceneLight light{{coord(rng), coord(rng), coord(rng) * 0.25f}, radius};
+            lights.push_back(light);
+            if (lights.size() < count && rng() % 3 == 0) {
+                lights.push_back({light.pos + RE::NiPoint3{jitter(rng), jitter(rng), jitter(rng)}, light.radius});
+            }
+        }
+        std::shuffle(lights.begin(), lights.end(), rng);
+        return lights;
+    }
+
+    // Every new light against every light kept so far
+    class PairwiseClusters {
+    public:
+        void Clear() { lights_.clear(); }
+
+        bool Add(const RE::NiPoint3& pos, float radius) {
+            for (const auto& other : lights_) {
+                if (pos.GetSquaredDistance(other.pos) < kMergeRadius * kMergeRadius &&
+                    std::abs(radius - other.radius) < kRadiusTolerance) {
+                    return false;
+                }
+            }
+            lights_.push_back({pos, radius});
+            return true;
+        }
+
+    private:
+        std::vector<SceneLight> lights_;
+    };
+
+    template <class Clusters>
+    double BestNsPerLight(Clusters& clusters, const std::vector<SceneLight>& scene, std::vector<bool>& kept) {
+        int runs = std::max(3, static_cast<int>(20000 / scene.size()));
+        double best = 0.0;
+        for (int run = 0; run < runs; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            clusters.Clear();
+            for (size_t i = 0; i < scene.size(); ++i) {
+                kept[i] = clusters.Add(scene[i].pos, scene[i].radius);
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = run == 0 ? ns : std::min(best, ns);
+        }
+        return best / static_cast<double>(scene.size());
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxLights = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000;
+
+    std::mt19937 rng(42);
+    LightClusters clusters(kMergeRadius, kRadiusTolerance);
+    PairwiseClusters pairwise;
+
+    std::printf("%8s %8s %18s %18s\n", "lights", "kept", "grid ns/light", "pairwise ns/light");
+    for (size_t count = 10; count <= maxLights; count *= 10) {
+        auto scene = MakeScene(count, rng);
+        std::vector<bool> gridKept(count), pairwiseKept(count);
+        double gridNs = BestNsPerLight(clusters, scene, gridKept);
+        double pairwiseNs = BestNsPerLight(pairwise, scene, pairwiseKept);
+        if (gridKept != pairwiseKept) {
+            std::fprintf(stderr, "clusters disagree with the pairwise reference at %zu lights\n", count);
+            return 1;
+        }
+        std::printf("%8zu %8zu %18.1f %18.1f\n", count, clusters.Size(), gridNs, pairwiseNs);
+    }
+    return 0;
+}
@@ -0,0 +1,8 @@
+#pragma once
+
+// Stands in for the plugin's PCH.h, host builds only get the few game types the tested code uses
+
+#include "RE/Skyrim.h"
+#include "SKSE/SKSE.h"
+
+using namespace std::literals;
@@ -0,0 +1,66 @@
+// Shadow candidate selection on the tracker: over the limit, the furthest shadowed actor goes first,
+// including actors in the hysteresis band past NpcMaxDistance that still keep their shadows.
+
+#include <vector>
+
+#include "TestCheck.h"
+#include "actor/ActorTracker.h"
+#include "core/Config.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    constexpr uint32_t kLight = 0x0001D4EC;
+
+    struct PlacedActor {
+        RE::Actor actor;
+        bool hasShadows;
+    };
+}
+
+int main() {
+    const auto& config = GetConfig();
+    CHECK(config.shadowHysteresisDistance > 0.0f);
+    float bandMiddle = config.npcMaxDistance + config.shadowHysteresisDistance * 0.5f;
+
+    // The player stands at the origin
+    std::vector<PlacedActor> placed;
+    placed.reserve(4);
+    placed.push_back({RE::Actor(0xFF000B01), true});   // Near, shadowed
+    placed.push_back({RE::Actor(0xFF000B02), true});   // Inside the exit band, still shadowed
+    placed.push_back({RE::Actor(0xFF000B03), false});  // Inside the exit band, static
+    placed.push_back({RE::Actor(0xFF000B04), false});  // Near, static
+    placed[0].actor.position = {config.npcMaxDistance * 0.5f, 0.0f, 0.0f};
+    placed[1].actor.position = {0.0f, bandMiddle, 0.0f};
+    placed[2].actor.position = {-bandMiddle, 0.0f, 0.0f};
+    placed[3].actor.position = {0.0f, -config.npcMaxDistance * 0.25f, 0.0f};
+
+    auto& tracker = ActorTracker::GetSingleton();
+    for (auto& entry : placed) {
+        RE::HostForms::Table()[entry.actor.GetFormID()] = &entry.actor;
+        tracker.SetActorLightShadowState(entry.actor.GetFormID(), kLight, entry.hasShadows);
+    }
+    tracker.RefreshCachedPositions();
+
+    // Over the limit by one: the band actor is furthest and must lose its shadows first
+    {
+        auto candidates = tracker.SelectShadowCandidates(1, false, false, config.GetNpcExitDistance());
+        CHECK(candidates.size() == 1);
+        CHECK(!candidates.empty() && candidates[0].actorFormId == placed[1].actor.GetFormID());
+
+        candidates = tracker.SelectShadowCandidates(4, false, false, config.GetNpcExitDistance());
+        CHECK(candidates.size() == 2);
+        CHECK(candidates.size() == 2 && candidates[1].actorFormId == placed[0].actor.GetFormID());
+    }
+
+    // Under the limit: new shadows stay within NpcMaxDistance, so the static band actor is never picked
+    {
+        auto candidates = tracker.SelectShadowCandidates(4, true, true, config.npcMaxDistance);
+        CHECK(candidates.size() == 1);
+        CHECK(!candidates.empty() && candidates[0].actorFormId == placed[3].actor.GetFormID());
+    }
+
+    tracker.ClearAllActors();
+    RE::HostForms::Table().clear();
+    return TestCheck::Finish("ShadowCandidatesTest");
+}
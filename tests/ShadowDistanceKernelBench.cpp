@@ -0,0 +1,67 @@
+// Throughput of each shadow distance kernel on batches from a handful of lights to far more than any
+// scene holds. Usage: ShadowDistanceKernelBench [maxLights], defaults to 65536.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+#include "utils/ShadowDistanceKernel.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    double BestNsPerLight(ShadowDistanceKernel kernel, ShadowLightBatch& batch, const RE::NiPoint3& origin) {
+        size_t repeats = std::max<size_t>(1, 1000000 / batch.Size());
+        double best = 0.0;
+        for (int run = 0; run < 5; ++run) {
+            auto start = std::chrono::steady_clock::now();
+            for (size_t r = 0; r < repeats; ++r) {
+                EvaluateShadowDistancesWith(kernel, batch, origin, 2048.0f);
+            }
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            best = run == 0 ? ns : std::min(best, ns);
+        }
+        return best / static_cast<double>(repeats * batch.Size());
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t maxLights = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 65536;
+
+    constexpr struct {
+        ShadowDistanceKernel kernel;
+        const char* name;
+    } kKernels[] = {{ShadowDistanceKernel::Scalar, "scalar"},
+                    {ShadowDistanceKernel::Sse2, "SSE2"},
+                    {ShadowDistanceKernel::Avx2, "AVX2"}};
+
+    std::printf("dispatched kernel: %s\n", GetShadowDistanceKernelName());
+    std::printf("%8s", "lights");
+    for (const auto& k : kKernels) {
+        std::printf(" %14s", (std::string(k.name) + " ns/light").c_str());
+    }
+    std::printf("\n");
+
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coord(-20000.0f, 20000.0f);
+    std::uniform_real_distribution<float> radius(64.0f, 2048.0f);
+    RE::NiPoint3 origin{0.0f, 0.0f, 0.0f};
+    for (size_t count = 13; count <= maxLights; count *= 4) {
+        ShadowLightBatch batch;
+        for (size_t i = 0; i < count; ++i) {
+            batch.Push({coord(rng), coord(rng), coord(rng) * 0.1f}, radius(rng));
+        }
+
+        std::printf("%8zu", count);
+        for (const auto& k : kKernels) {
+            if (EvaluateShadowDistancesWith(k.kernel, batch, origin, 0.0f)) {
+                std::printf(" %14.3f", BestNsPerLight(k.kernel, batch, origin));
+            } else {
+                std::printf(" %14s", "n/a");
+            }
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,124 @@
+// The SSE2 and AVX2 shadow distance kernels against the scalar one on random batches: every length up
+// to a few vector widths so each tail length is hit, negative radii, NaN and infinite inputs.
+
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <random>
+
+#include "TestCheck.h"
+#include "utils/ShadowDistanceKernel.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+    constexpr float kInf = std::numeric_limits<float>::infinity();
+
+    float RandomValue(std::mt19937& rng, float low, float high) {
+        switch (rng() % 40) {
+            case 0:
+                return kNaN;
+            case 1:
+                return (rng() & 1) ? kInf : -kInf;
+            case 2:
+                return -0.0f;
+            default:
+                return std::uniform_real_distribution<float>(low, high)(rng);
+        }
+    }
+
+    ShadowLightBatch MakeBatch(std::mt19937& rng, size_t count) {
+        ShadowLightBatch batch;
+        for (size_t i = 0; i < count; ++i) {
+            if (rng() % 8 == 0) {
+                // Exactly on the boundary of the origin used below, whole numbers keep the squares exact
+                float r = static_cast<float>(rng() % 512);
+                batch.Push({100.0f + r + 64.0f, 200.0f, 300.0f}, r);
+                continue;
+            }
+            RE::NiPoint3 pos{RandomValue(rng, -20000.0f, 20000.0f), RandomValue(rng, -20000.0f, 20000.0f),
+                             RandomValue(rng, -4000.0f, 4000.0f)};
+            batch.Push(pos, RandomValue(rng, -800.0f, 4000.0f));
+        }
+        return batch;
+    }
+
+    bool SameFloat(float a, float b) {
+        return (std::isnan(a) && std::isnan(b)) || std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b);
+    }
+
+    void CompareKernel(ShadowDistanceKernel kernel, const char* name, std::mt19937& rng) {
+        ShadowLightBatch probe;
+        if (!EvaluateShadowDistancesWith(kernel, probe, {}, 0.0f)) {
+            std::printf("%s kernel not available, skipped\n", name);
+            return;
+        }
+
+        std::vector<size_t> lengths;
+        for (size_t length = 0; length <= 40; ++length) {
+            lengths.push_back(length);
+        }
+        for (size_t tail = 0; tail < 8; ++tail) {
+            lengths.push_back(4096 + tail);
+        }
+
+        for (size_t length : lengths) {
+            for (int round = 0; round < 8; ++round) {
+                auto batch = MakeBatch(rng, length);
+                RE::NiPoint3 origin{100.0f, 200.0f, 300.0f};
+                float extra = 64.0f;
+                if (round >= 4) {
+                    origin = {RandomValue(rng, -5000.0f, 5000.0f), RandomValue(rng, -5000.0f, 5000.0f),
+                              RandomValue(rng, -500.0f, 500.0f)};
+                    extra = RandomValue(rng, -1500.0f, 3000.0f);
+                }
+
+                ShadowLightBatch expected = batch;
+                CHECK(EvaluateShadowDistancesWith(ShadowDistanceKernel::Scalar, expected, origin, extra));
+                CHECK(EvaluateShadowDistancesWith(kernel, batch, origin, extra));
+                CHECK(batch.inRange.size() == length && batch.distanceSq.size() == length);
+                for (size_t i = 0; i < std::min(length, batch.inRange.size()); ++i) {
+                    if (batch.inRange[i] != expected.inRange[i] ||
+                        !SameFloat(batch.distanceSq[i], expected.distanceSq[i])) {
+                        std::printf("%s differs at %zu of %zu: r=%g extra=%g\n", name, i, length, batch.radius[i],
+                                    extra);
+                        ++TestCheck::g_failures;
+                        return;
+                    }
+                }
+            }
+        }
+        std::printf("%s kernel matches scalar\n", name);
+    }
+}
+
+int main() {
+    // The scalar kernel itself on the documented rules
+    {
+        ShadowLightBatch batch;
+        batch.Push({10.0f, 0.0f, 0.0f}, 4.0f);    // Exactly radius + extra away
+        batch.Push({10.5f, 0.0f, 0.0f}, 4.0f);    // Just beyond
+        batch.Push({0.0f, 0.0f, 0.0f}, -20.0f);   // Negative effective distance, never in range
+        batch.Push({kNaN, 0.0f, 0.0f}, 100.0f);   // NaN position
+        batch.Push({1.0f, 0.0f, 0.0f}, kNaN);     // NaN radius
+        CHECK(EvaluateShadowDistancesWith(ShadowDistanceKernel::Scalar, batch, {}, 6.0f));
+        CHECK(batch.inRange == std::vector<uint8_t>({1, 0, 0, 0, 0}));
+        CHECK(batch.distanceSq[0] == 100.0f);
+    }
+
+    std::mt19937 rng(2024);
+    CompareKernel(ShadowDistanceKernel::Sse2, "SSE2", rng);
+    CompareKernel(ShadowDistanceKernel::Avx2, "AVX2", rng);
+
+    // The dispatched kernel agrees as well
+    {
+        auto batch = MakeBatch(rng, 1003);
+        ShadowLightBatch expected = batch;
+        EvaluateShadowDistances(batch, {1.0f, 2.0f, 3.0f}, 128.0f);
+        EvaluateShadowDistancesWith(ShadowDistanceKernel::Scalar, expected, {1.0f, 2.0f, 3.0f}, 128.0f);
+        CHECK(batch.inRange == expected.inRange);
+    }
+
+    return TestCheck::Finish("ShadowDistanceKernelTest");
+}
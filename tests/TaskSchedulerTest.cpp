@@ -0,0 +1,86 @@
+// Timing of the timer-wheel scheduler: tasks scheduled at arbitrary points between ticks must never
+// run before their delay, and sequence steps must run in order, each its delay after the previous one.
+
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "TestCheck.h"
+#include "utils/TaskScheduler.h"
+
+using namespace ActorShadowLimiter;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    struct Record {
+        Clock::time_point scheduled;
+        std::chrono::milliseconds delay;
+        Clock::time_point ran;
+    };
+}
+
+int main() {
+    auto& scheduler = TaskScheduler::GetSingleton();
+
+    constexpr size_t kTasks = 300;
+    std::mutex mutex;
+    std::vector<Record> records(kTasks);
+    size_t finished = 0;
+
+    // Schedule from varying offsets into the current tick, so rounding to the wheel cannot hide an early run
+    std::mt19937 rng(11);
+    for (size_t i = 0; i < kTasks; ++i) {
+        std::this_thread::sleep_for(std::chrono::microseconds(rng() % 5000));
+        auto delay = std::chrono::milliseconds(rng() % 80);
+        std::lock_guard<std::mutex> lock(mutex);
+        records[i].scheduled = Clock::now();
+        records[i].delay = delay;
+        scheduler.Schedule(delay, [&, i]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            records[i].ran = Clock::now();
+            ++finished;
+        });
+    }
+
+    std::vector<Clock::time_point> steps(3);
+    auto step = [&](size_t index) {
+        return [&, index]() {
+            std::lock_guard<std::mutex> lock(mutex);
+            steps[index] = Clock::now();
+        };
+    };
+    scheduler.ScheduleSequence({
+        {std::chrono::milliseconds(5), step(0)},
+        {std::chrono::milliseconds(40), step(1)},
+        {std::chrono::milliseconds(0), step(2)},
+    });
+    auto sequenceStart = Clock::now();
+
+    for (int wait = 0; wait < 400; ++wait) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (finished == kTasks && steps[2] != Clock::time_point{}) break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    CHECK(finished == kTasks);
+    size_t early = 0;
+    for (const auto& record : records) {
+        if (record.ran != Clock::time_point{} && record.ran < record.scheduled + record.delay) {
+            ++early;
+        }
+    }
+    if (early > 0) {
+        std::printf("%zu of %zu tasks ran before their delay\n", early, kTasks);
+    }
+    CHECK(early == 0);
+
+    CHECK(steps[0] >= sequenceStart);
+    CHECK(steps[1] >= steps[0] + std::chrono::milliseconds(40));
+    CHECK(steps[2] > steps[1]);
+
+    return TestCheck::Finish("TaskSchedulerTest");
+}
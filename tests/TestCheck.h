@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdio>
+
+// Minimal assertion helpers for the host tests, a failed check is reported and the test exits non-zero
+namespace TestCheck {
+    inline int g_failures = 0;
+
+    inline int Finish(const char* name) {
+        if (g_failures > 0) {
+            std::printf("%s: %d check(s) failed\n", name, g_failures);
+            return 1;
+        }
+        std::printf("%s: all checks passed\n", name);
+        return 0;
+    }
+}
+
+#define CHECK(condition)                                                                \
+    do {                                                                                \
+        if (!(condition)) {                                                             \
+            std::printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            ++TestCheck::g_failures;                                                    \
+        }                                                                               \
+    } while (false)
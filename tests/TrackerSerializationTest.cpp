@@ -0,0 +1,133 @@
+// Tracker co-save record: WriteTrackedActors -> ReadTrackedActors through an in-memory record must
+// reproduce the tracked actors, and damaged or outdated records must be refused.
+
+#include <cstring>
+#include <vector>
+
+#include "TestCheck.h"
+#include "actor/TrackerSerialization.h"
+
+using namespace ActorShadowLimiter;
+
+namespace {
+    // Stands in for SKSE's serialization interface, reads past the end come back short
+    struct RecordBuffer {
+        std::vector<std::uint8_t> bytes;
+        size_t readOffset = 0;
+
+        bool WriteRecordData(const void* data, std::uint32_t length) {
+            auto* begin = static_cast<const std::uint8_t*>(data);
+            bytes.insert(bytes.end(), begin, begin + length);
+            return true;
+        }
+
+        std::uint32_t ReadRecordData(void* data, std::uint32_t length) {
+            auto count = static_cast<std::uint32_t>(std::min<size_t>(length, bytes.size() - readOffset));
+            std::memcpy(data, bytes.data() + readOffset, count);
+            readOffset += count;
+            return count;
+        }
+    };
+
+    // Maps saved IDs into another load order slot, forms of the removed plugin 0x05 no longer resolve
+    bool Resolve(std::uint32_t oldFormId, std::uint32_t& newFormId) {
+        if ((oldFormId >> 24) == 0x05) {
+            return false;
+        }
+        newFormId = (oldFormId >> 24) == 0x03 ? (oldFormId & 0x00FFFFFF) | 0x04000000 : oldFormId;
+        return true;
+    }
+
+    bool NoRemap(std::uint32_t oldFormId, std::uint32_t& newFormId) {
+        newFormId = oldFormId;
+        return true;
+    }
+
+    std::vector<SavedActor> MakeActors() {
+        return {
+            {0x00000014, {{0x0001D4EC, true}, {0x0300ABCD, false}}},
+            {0xFF000801, {{0x0001D4EC, false}}},
+            {0x03001234, {{0x0300ABCD, true}, {0x05000800, true}}},
+            {0x05000900, {{0x0001D4EC, true}}},  // Actor from the removed plugin
+            {0xFF000802, {{0x05000801, true}}},  // Only light from the removed plugin
+        };
+    }
+}
+
+int main() {
+    auto saved = MakeActors();
+    RecordBuffer record;
+    CHECK(WriteTrackedActors(record, std::span<const SavedActor>(saved)));
+    CHECK(record.bytes.size() == 4 * (1 + 2 * 5 + 2 * 7));
+
+    // Round trip without remapping keeps every actor, light and shadow state
+    {
+        RecordBuffer in{record.bytes};
+        std::vector<SavedActor> actors;
+        CHECK(ReadTrackedActors(in, kTrackerRecordVersion, actors, NoRemap));
+        CHECK(in.readOffset == record.bytes.size());
+        CHECK(actors.size() == saved.size());
+        for (size_t i = 0; i < std::min(actors.size(), saved.size()); ++i) {
+            CHECK(actors[i].actorFormId == saved[i].actorFormId);
+            CHECK(actors[i].lights.size() == saved[i].lights.size());
+            for (size_t j = 0; j < std::min(actors[i].lights.size(), saved[i].lights.size()); ++j) {
+                CHECK(actors[i].lights[j].formId == saved[i].lights[j].formId);
+                CHECK(actors[i].lights[j].hasShadows == saved[i].lights[j].hasShadows);
+            }
+        }
+    }
+
+    // Forms that do not resolve are dropped, along with actors left without lights
+    {
+        RecordBuffer in{record.bytes};
+        std::vector<SavedActor> actors;
+        CHECK(ReadTrackedActors(in, kTrackerRecordVersion, actors, Resolve));
+        CHECK(in.readOffset == record.bytes.size());
+        CHECK(actors.size() == 3);
+        if (actors.size() == 3) {
+            CHECK(actors[0].actorFormId == 0x00000014);
+            CHECK(actors[0].lights.size() == 2);
+            CHECK(actors[0].lights[1].formId == 0x0400ABCD);
+            CHECK(actors[1].actorFormId == 0xFF000801);
+            CHECK(actors[2].actorFormId == 0x04001234);
+            CHECK(actors[2].lights.size() == 1);
+            CHECK(actors[2].lights[0].formId == 0x0400ABCD);
+            CHECK(actors[2].lights[0].hasShadows);
+        }
+    }
+
+    // A record from another version is refused before anything is read
+    {
+        RecordBuffer in{record.bytes};
+        std::vector<SavedActor> actors;
+        CHECK(!ReadTrackedActors(in, kTrackerRecordVersion + 1, actors, NoRemap));
+        CHECK(in.readOffset == 0);
+        CHECK(actors.empty());
+    }
+
+    // Every truncation point fails on the short read, an inflated actor count runs out of data
+    for (size_t length = 0; length < record.bytes.size(); length += 2) {
+        RecordBuffer in{std::vector<std::uint8_t>(record.bytes.begin(), record.bytes.begin() + length)};
+        std::vector<SavedActor> actors;
+        CHECK(!ReadTrackedActors(in, kTrackerRecordVersion, actors, NoRemap));
+    }
+    {
+        RecordBuffer in{record.bytes};
+        std::uint32_t hugeCount = 0xFFFFFFFF;
+        std::memcpy(in.bytes.data(), &hugeCount, sizeof(hugeCount));
+        std::vector<SavedActor> actors;
+        CHECK(!ReadTrackedActors(in, kTrackerRecordVersion, actors, NoRemap));
+        CHECK(actors.size() == saved.size());
+    }
+
+    // An empty tracker is a valid record
+    {
+        RecordBuffer out;
+        CHECK(WriteTrackedActors(out, std::span<const SavedActor>()));
+        std::vector<SavedActor> actors;
+        CHECK(ReadTrackedActors(out, kTrackerRecordVersion, actors, NoRemap));
+        CHECK(actors.empty());
+    }
+
+    return TestCheck::Finish("TrackerSerializationTest");
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+// Host stand-in for CommonLibSSE's RE/Skyrim.h. Only the members the tested code touches exist, and
+// forms are looked up in a table the test fills instead of the game's form map.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace RE {
+    using FormID = std::uint32_t;
+
+    class NiPoint3 {
+    public:
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        NiPoint3() = default;
+        NiPoint3(float a_x, float a_y, float a_z) : x(a_x), y(a_y), z(a_z) {}
+
+        NiPoint3 operator-(const NiPoint3& other) const { return {x - other.x, y - other.y, z - other.z}; }
+        NiPoint3 operator+(const NiPoint3& other) const { return {x + other.x, y + other.y, z + other.z}; }
+        NiPoint3 operator*(float scale) const { return {x * scale, y * scale, z * scale}; }
+
+        float SqrLength() const { return x * x + y * y + z * z; }
+        float Length() const { return std::sqrt(SqrLength()); }
+        float GetSquaredDistance(const NiPoint3& other) const { return (*this - other).SqrLength(); }
+        float GetDistance(const NiPoint3& other) const { return std::sqrt(GetSquaredDistance(other)); }
+    };
+
+    class TESForm;
+    class TESObjectLIGH;
+    class TESObjectARMO;
+    class TESObjectCELL;
+    class SpellItem;
+
+    namespace HostForms {
+        inline std::unordered_map<FormID, TESForm*>& Table() {
+            static std::unordered_map<FormID, TESForm*> table;
+            return table;
+        }
+    }
+
+    class TESForm {
+    public:
+        explicit TESForm(FormID formId) : formID(formId) {}
+        virtual ~TESForm() = default;
+
+        FormID GetFormID() const { return formID; }
+
+        static TESForm* LookupByID(FormID formId) {
+            auto it = HostForms::Table().find(formId);
+            return it != HostForms::Table().end() ? it->second : nullptr;
+        }
+
+        template <class T>
+        static T* LookupByID(FormID formId) {
+            return dynamic_cast<T*>(LookupByID(formId));
+        }
+
+        FormID formID = 0;
+    };
+
+    class Actor : public TESForm {
+    public:
+        using TESForm::TESForm;
+
+        NiPoint3 GetPosition() const { return position; }
+        const char* GetName() const { return ""; }
+
+        NiPoint3 position;
+    };
+
+    class PlayerCharacter : public Actor {
+    public:
+        using Actor::Actor;
+
+        static PlayerCharacter* GetSingleton() {
+            static PlayerCharacter player(0x14);
+            return &player;
+        }
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+// Host stand-in for CommonLibSSE's SKSE/SKSE.h, log calls are dropped and tasks run on the calling thread
+
+#include <functional>
+
+namespace SKSE::log {
+    template <class... Args>
+    void info(Args&&...) {}
+    template <class... Args>
+    void warn(Args&&...) {}
+    template <class... Args>
+    void error(Args&&...) {}
+}
+
+namespace SKSE {
+    struct TaskInterface {
+        void AddTask(std::function<void()> task) const { task(); }
+    };
+
+    inline const TaskInterface* GetTaskInterface() {
+        static const TaskInterface tasks;
+        return &tasks;
+    }
+}